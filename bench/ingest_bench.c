@@ -0,0 +1,261 @@
+/*
+ * Ingest benchmark - hammers a running linestatus socket and reports how
+ * many producer connections / updates per second it sustains.
+ *
+ *   oneshot: every update is its own connection (connect, write, shutdown,
+ *            wait for the server to close) - what send-status + socat does
+ *   stream:  N persistent connections each streaming M lines
+ *
+ * The server only closes a connection after it has read everything up to
+ * EOF, so waiting for that close makes the numbers end-to-end for ingest.
+ *
+ * With --timestamp every value carries its send time ("key:60@T"), and
+ * --stats prints the server's stats line afterwards, which then includes
+ * receive -> screen and send -> screen latency from presentation feedback
+ * (stats are also requested once before the run, which turns that on).
+ *
+ * --segments N sends N-segment vectors ("key:1/2/3...") instead of plain
+ * values; with --stats the run then fails if linestatus ever applied part
+ * of a vector in one pass and the rest in another ("vectors_split").
+ *
+ * Build: make bench
+ * Run:   ./ingest-bench --socket $XDG_RUNTIME_DIR/linestatus-bench.sock --mode oneshot
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define MAX_KEY 31          // Longest key linestatus accepts
+#define MAX_SEGMENTS 128    // Longest vector it accepts
+#define LINE_SIZE 1024      // Fits the longest key, vector and timestamp
+
+static const char *socket_path = NULL;
+static const char *mode = "oneshot";
+static int concurrency = 16;    // Threads (oneshot) or persistent clients (stream)
+static int total = 20000;       // Connections (oneshot) or lines per client (stream)
+static const char *key = "bench";
+static int timestamps = 0;      // Append "@<wall clock µs>" to every value
+static int show_stats = 0;      // Query and print the server stats after the run
+static int segments = 1;        // Values per line, > 1 sends vectors
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int connect_socket(void) {
+    struct sockaddr_un addr;
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+    
+    // A full backlog shows up as EAGAIN - back off briefly and retry
+    while (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        if (errno != EAGAIN && errno != EINTR) {
+            close(fd);
+            return -1;
+        }
+        usleep(100);
+    }
+    return fd;
+}
+
+// One update line, optionally stamped with the send time
+static int format_update(char *line, size_t size, int i) {
+    int len = snprintf(line, size, "%s:%d", key, i % 101);
+    
+    for (int s = 1; s < segments; s++) {
+        len += snprintf(line + len, size - len, "/%d", (i + s) % 101);
+    }
+    if (timestamps) {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        return len + snprintf(line + len, size - len, "@%lld\n", (long long)tv.tv_sec * 1000000 + tv.tv_usec);
+    }
+    return len + snprintf(line + len, size - len, "\n");
+}
+
+static int write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(fd, data, len);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        data += written;
+        len -= written;
+    }
+    return 0;
+}
+
+// Half-close and wait until the server has consumed everything and closed
+static void finish_connection(int fd) {
+    char scratch[256];
+    shutdown(fd, SHUT_WR);
+    while (read(fd, scratch, sizeof(scratch)) > 0) {
+        // Replies (if any) are ignored
+    }
+    close(fd);
+}
+
+static void *oneshot_worker(void *arg) {
+    int count = *(int *)arg;
+    char line[LINE_SIZE];
+    
+    for (int i = 0; i < count; i++) {
+        int fd = connect_socket();
+        if (fd < 0) {
+            perror("connect");
+            return NULL;
+        }
+        int len = format_update(line, sizeof(line), i);
+        write_all(fd, line, len);
+        finish_connection(fd);
+    }
+    return NULL;
+}
+
+static void *stream_worker(void *arg) {
+    int count = *(int *)arg;
+    char line[LINE_SIZE];
+    int fd = connect_socket();
+    
+    if (fd < 0) {
+        perror("connect");
+        return NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        int len = format_update(line, sizeof(line), i);
+        if (write_all(fd, line, len) < 0) {
+            perror("write");
+            break;
+        }
+    }
+    finish_connection(fd);
+    return NULL;
+}
+
+// Send "stats" and copy the reply to stdout (or just discard it);
+// returns the "vectors_split" counter, -1 if there was none
+static long query_stats(int print) {
+    char reply[8192];
+    size_t total_len = 0;
+    ssize_t len;
+    int fd = connect_socket();
+    
+    if (fd < 0) {
+        perror("connect");
+        return -1;
+    }
+    write_all(fd, "stats\n", 6);
+    shutdown(fd, SHUT_WR);
+    while ((len = read(fd, reply + total_len, sizeof(reply) - 1 - total_len)) > 0) {
+        if (print) {
+            fwrite(reply + total_len, 1, len, stdout);
+        }
+        total_len += len;
+        if (total_len == sizeof(reply) - 1) {
+            total_len = 0; // Only the head of the reply is parsed
+        }
+    }
+    close(fd);
+    
+    reply[total_len] = '\0';
+    const char *split = strstr(reply, "\"vectors_split\":");
+    return split != NULL ? strtol(split + strlen("\"vectors_split\":"), NULL, 10) : -1;
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s --socket PATH [--mode oneshot|stream] [--concurrency N] [--count N] [--key KEY]\n", prog);
+    printf("          [--timestamp] [--stats] [--segments N]\n");
+    printf("  oneshot: --count connections spread over --concurrency threads (default 20000 / 16)\n");
+    printf("  stream:  --concurrency persistent clients sending --count lines each\n");
+    printf("  --segments N sends N-value vectors (up to %d); with --stats, fails if one was split\n", MAX_SEGMENTS);
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+            mode = argv[++i];
+        } else if (strcmp(argv[i], "--concurrency") == 0 && i + 1 < argc) {
+            concurrency = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            total = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--key") == 0 && i + 1 < argc) {
+            key = argv[++i];
+        } else if (strcmp(argv[i], "--timestamp") == 0) {
+            timestamps = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            show_stats = 1;
+        } else if (strcmp(argv[i], "--segments") == 0 && i + 1 < argc) {
+            segments = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    
+    int streaming = strcmp(mode, "stream") == 0;
+    if (socket_path == NULL || concurrency <= 0 || total <= 0 || strlen(key) > MAX_KEY || segments < 1 || segments > MAX_SEGMENTS || (!streaming && strcmp(mode, "oneshot") != 0)) {
+        usage(argv[0]);
+        return 1;
+    }
+    
+    pthread_t *threads = calloc(concurrency, sizeof(pthread_t));
+    int *counts = calloc(concurrency, sizeof(int));
+    for (int i = 0; i < concurrency; i++) {
+        counts[i] = streaming ? total : total / concurrency + (i < total % concurrency);
+    }
+    
+    // The first stats request turns on presentation tracking in linestatus
+    if (show_stats) {
+        query_stats(0);
+    }
+    
+    double start = now_seconds();
+    for (int i = 0; i < concurrency; i++) {
+        pthread_create(&threads[i], NULL, streaming ? stream_worker : oneshot_worker, &counts[i]);
+    }
+    for (int i = 0; i < concurrency; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = now_seconds() - start;
+    
+    long updates = streaming ? (long)total * concurrency : total;
+    long connections = streaming ? concurrency : total;
+    printf("mode=%s clients=%d connections=%ld updates=%ld seconds=%.3f conn_per_sec=%.0f updates_per_sec=%.0f\n",
+           mode, concurrency, connections, updates, elapsed, connections / elapsed, updates / elapsed);
+    
+    long split = 0;
+    if (show_stats) {
+        usleep(200 * 1000); // Let the last frames reach the screen
+        split = query_stats(1);
+    }
+    
+    free(threads);
+    free(counts);
+    if (segments > 1 && split != 0) {
+        fprintf(stderr, "FAIL: %ld vector%s applied in more than one pass\n", split, split == 1 ? "" : "s");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,607 @@
+/*
+ * Mock layer-shell compositor - hosts linestatus headless and counts what
+ * it costs the compositor per update.
+ *
+ * Implements just enough of wl_compositor, wl_shm (libwayland's built-in
+ * implementation), wl_output, xdg_wm_base and zwlr_layer_shell_v1 for GTK
+ * and gtk4-layer-shell to map their surfaces. Nothing is rendered: every
+ * commit is recorded (attached buffer size, damaged area, area not covered
+ * by the opaque region, frame callbacks) and the buffer is released right away, like a compositor that uploads
+ * shm buffers on commit. Frame callbacks are answered from a 60 Hz timer.
+ *
+ *   SIGUSR1   print counters accumulated since the previous SIGUSR1
+ *   SIGINT/TERM  print totals and exit
+ *
+ * Counter lines are key=value, like ingest-bench output:
+ *   commits=120 buffers=118 buffer_bytes=2039040 damage_bytes=2039040 ...
+ *
+ * Build: make mock-compositor
+ * Run:   ./mock-compositor --socket linestatus-mock [--verbose]
+ *        WAYLAND_DISPLAY=linestatus-mock ./linestatus --type mock
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wayland-server.h>
+
+#include "wlr-layer-shell-unstable-v1-server-protocol.h"
+#include "xdg-shell-server-protocol.h"
+
+#define OUTPUT_WIDTH 1920
+#define OUTPUT_HEIGHT 1080
+#define FRAME_INTERVAL_MS 16
+
+typedef struct {
+    unsigned long commits;
+    unsigned long buffers;          // Commits with a new buffer attached
+    unsigned long buffer_bytes;     // Full size of those buffers
+    unsigned long damage_bytes;     // Damaged part of them (what an upload would copy)
+    unsigned long damage_area;      // Damaged pixels
+    unsigned long blend_area;       // Committed pixels outside the opaque region (need blending)
+    unsigned long frame_callbacks;  // Frame callbacks answered
+    unsigned long configures;
+    unsigned long surfaces;
+} Counters;
+
+typedef struct MockSurface {
+    struct wl_resource *resource;
+    struct wl_resource *pending_buffer;
+    struct wl_listener pending_buffer_destroy;
+    int buffer_attached;                // attach() called since the last commit
+    long pending_damage;                // Damaged area in buffer pixels
+    int damage_whole;                   // Surface-coordinate damage: count the whole buffer
+    int scale;
+    struct wl_list pending_frames;      // wl_callback resources
+    struct wl_resource *role;           // Layer or xdg surface, NULL before one is assigned
+    int configured;                     // Initial configure sent
+    long pending_opaque;                // Opaque area set since the last commit, -1 if unchanged
+    long opaque_area;                   // Current opaque area in surface pixels
+    int width, height;                  // Size requested by the client (layer surfaces)
+    uint32_t anchor;
+    int reconfigure;                    // Size or anchor changed after the initial configure
+} MockSurface;
+
+static struct wl_display *display = NULL;
+static struct wl_event_source *frame_timer = NULL;
+static struct wl_list frame_callbacks;  // Committed, waiting for the next tick
+static Counters total;
+static Counters snapshot;               // total at the previous SIGUSR1
+static int verbose = 0;
+static uint32_t serial = 1;
+
+static void print_counters(const char *label, const Counters *now, const Counters *base) {
+    printf("%s commits=%lu buffers=%lu buffer_bytes=%lu damage_bytes=%lu damage_area=%lu blend_area=%lu "
+           "frame_callbacks=%lu configures=%lu surfaces=%lu\n", label,
+           now->commits - base->commits, now->buffers - base->buffers,
+           now->buffer_bytes - base->buffer_bytes, now->damage_bytes - base->damage_bytes,
+           now->damage_area - base->damage_area, now->blend_area - base->blend_area,
+           now->frame_callbacks - base->frame_callbacks,
+           now->configures - base->configures, now->surfaces - base->surfaces);
+    fflush(stdout);
+}
+
+static void resource_destroy(struct wl_client *client, struct wl_resource *resource) {
+    (void)client;
+    wl_resource_destroy(resource);
+}
+
+// Requests that only change state this harness does not model
+static void ignore_region(struct wl_client *c, struct wl_resource *r, struct wl_resource *region) {
+    (void)c; (void)r; (void)region;
+}
+
+static void ignore_int(struct wl_client *c, struct wl_resource *r, int32_t value) {
+    (void)c; (void)r; (void)value;
+}
+
+static void ignore_uint(struct wl_client *c, struct wl_resource *r, uint32_t value) {
+    (void)c; (void)r; (void)value;
+}
+
+static void ignore_int2(struct wl_client *c, struct wl_resource *r, int32_t a, int32_t b) {
+    (void)c; (void)r; (void)a; (void)b;
+}
+
+static void ignore_int4(struct wl_client *c, struct wl_resource *r, int32_t a, int32_t b, int32_t d, int32_t e) {
+    (void)c; (void)r; (void)a; (void)b; (void)d; (void)e;
+}
+
+static void ignore_string(struct wl_client *c, struct wl_resource *r, const char *s) {
+    (void)c; (void)r; (void)s;
+}
+
+static void ignore(struct wl_client *c, struct wl_resource *r) {
+    (void)c; (void)r;
+}
+
+// Regions ------------------------------------------------------------------
+
+// Only the area is modelled; overlapping rectangles are counted twice
+static void region_add(struct wl_client *c, struct wl_resource *r, int32_t x, int32_t y, int32_t w, int32_t h) {
+    (void)c; (void)x; (void)y;
+    long *area = wl_resource_get_user_data(r);
+    *area += (long)w * h;
+}
+
+static void region_subtract(struct wl_client *c, struct wl_resource *r, int32_t x, int32_t y, int32_t w, int32_t h) {
+    (void)c; (void)x; (void)y;
+    long *area = wl_resource_get_user_data(r);
+    *area = *area > (long)w * h ? *area - (long)w * h : 0;
+}
+
+static const struct wl_region_interface region_impl = {
+    .destroy = resource_destroy,
+    .add = region_add,
+    .subtract = region_subtract,
+};
+
+static void region_free(struct wl_resource *resource) {
+    free(wl_resource_get_user_data(resource));
+}
+
+// Surfaces -----------------------------------------------------------------
+
+static void surface_buffer_destroyed(struct wl_listener *listener, void *data) {
+    (void)data;
+    MockSurface *surface = wl_container_of(listener, surface, pending_buffer_destroy);
+    surface->pending_buffer = NULL;
+    wl_list_remove(&surface->pending_buffer_destroy.link);
+    wl_list_init(&surface->pending_buffer_destroy.link);
+}
+
+static void surface_attach(struct wl_client *c, struct wl_resource *resource, struct wl_resource *buffer,
+                           int32_t x, int32_t y) {
+    (void)c; (void)x; (void)y;
+    MockSurface *surface = wl_resource_get_user_data(resource);
+    
+    wl_list_remove(&surface->pending_buffer_destroy.link);
+    wl_list_init(&surface->pending_buffer_destroy.link);
+    surface->pending_buffer = buffer;
+    surface->buffer_attached = 1;
+    if (buffer) {
+        wl_resource_add_destroy_listener(buffer, &surface->pending_buffer_destroy);
+    }
+}
+
+static void surface_damage(struct wl_client *c, struct wl_resource *resource,
+                           int32_t x, int32_t y, int32_t w, int32_t h) {
+    (void)c; (void)x; (void)y; (void)w; (void)h;
+    MockSurface *surface = wl_resource_get_user_data(resource);
+    surface->damage_whole = 1; // Surface coordinates: assume the worst
+}
+
+static void surface_damage_buffer(struct wl_client *c, struct wl_resource *resource,
+                                  int32_t x, int32_t y, int32_t w, int32_t h) {
+    (void)c; (void)x; (void)y;
+    MockSurface *surface = wl_resource_get_user_data(resource);
+    if (w > 0 && h > 0) {
+        surface->pending_damage += (long)w * h; // Overlaps are counted twice, clamped on commit
+    }
+}
+
+static void callback_unlink(struct wl_resource *resource) {
+    wl_list_remove(wl_resource_get_link(resource));
+}
+
+static void surface_frame(struct wl_client *client, struct wl_resource *resource, uint32_t id) {
+    MockSurface *surface = wl_resource_get_user_data(resource);
+    struct wl_resource *callback = wl_resource_create(client, &wl_callback_interface, 1, id);
+    
+    wl_resource_set_implementation(callback, NULL, NULL, callback_unlink);
+    wl_list_insert(surface->pending_frames.prev, wl_resource_get_link(callback));
+}
+
+static void surface_set_buffer_transform(struct wl_client *c, struct wl_resource *r, int32_t transform) {
+    (void)c; (void)r; (void)transform;
+}
+
+static void surface_set_buffer_scale(struct wl_client *c, struct wl_resource *resource, int32_t scale) {
+    (void)c;
+    MockSurface *surface = wl_resource_get_user_data(resource);
+    surface->scale = scale > 0 ? scale : 1;
+}
+
+static void send_configure(MockSurface *surface);
+
+static void surface_set_opaque_region(struct wl_client *c, struct wl_resource *resource, struct wl_resource *region) {
+    (void)c;
+    MockSurface *surface = wl_resource_get_user_data(resource);
+    surface->pending_opaque = region ? *(long *)wl_resource_get_user_data(region) : 0;
+}
+
+static void surface_commit(struct wl_client *c, struct wl_resource *resource) {
+    (void)c;
+    MockSurface *surface = wl_resource_get_user_data(resource);
+    struct wl_shm_buffer *shm = surface->pending_buffer ? wl_shm_buffer_get(surface->pending_buffer) : NULL;
+    unsigned long bytes = 0, damage = 0;
+    
+    total.commits++;
+    if (surface->pending_opaque >= 0) {
+        surface->opaque_area = surface->pending_opaque;
+        surface->pending_opaque = -1;
+    }
+    if (surface->buffer_attached && shm) {
+        int width = wl_shm_buffer_get_width(shm);
+        int height = wl_shm_buffer_get_height(shm);
+        long area = (long)width * height;
+        
+        long opaque = surface->opaque_area * surface->scale * surface->scale;
+        damage = surface->damage_whole || surface->pending_damage > area ? area : surface->pending_damage;
+        bytes = (unsigned long)wl_shm_buffer_get_stride(shm) * height;
+        total.buffers++;
+        total.buffer_bytes += bytes;
+        total.damage_area += damage;
+        total.damage_bytes += damage * 4;
+        total.blend_area += opaque < area ? area - opaque : 0;
+        
+        // "Uploaded" - hand the buffer straight back
+        wl_buffer_send_release(surface->pending_buffer);
+    }
+    
+    if (verbose) {
+        printf("commit surface=%u buffer_bytes=%lu damage_area=%lu frames=%d\n",
+               wl_resource_get_id(resource), bytes, damage, wl_list_length(&surface->pending_frames));
+    }
+    
+    wl_list_insert_list(&frame_callbacks, &surface->pending_frames);
+    wl_list_init(&surface->pending_frames);
+    surface->buffer_attached = 0;
+    surface->pending_damage = 0;
+    surface->damage_whole = 0;
+    
+    // The first commit after getting a role asks for the initial configure,
+    // later ones only if the layer surface asked for a new size or anchor
+    if (surface->role && (!surface->configured || surface->reconfigure)) {
+        surface->configured = 1;
+        surface->reconfigure = 0;
+        send_configure(surface);
+    }
+}
+
+static const struct wl_surface_interface surface_impl = {
+    .destroy = resource_destroy,
+    .attach = surface_attach,
+    .damage = surface_damage,
+    .frame = surface_frame,
+    .set_opaque_region = surface_set_opaque_region,
+    .set_input_region = ignore_region,
+    .commit = surface_commit,
+    .set_buffer_transform = surface_set_buffer_transform,
+    .set_buffer_scale = surface_set_buffer_scale,
+    .damage_buffer = surface_damage_buffer,
+};
+
+static void surface_free(struct wl_resource *resource) {
+    MockSurface *surface = wl_resource_get_user_data(resource);
+    struct wl_resource *callback, *tmp;
+    
+    wl_resource_for_each_safe(callback, tmp, &surface->pending_frames) {
+        wl_resource_destroy(callback);
+    }
+    wl_list_remove(&surface->pending_buffer_destroy.link);
+    free(surface);
+}
+
+static void compositor_create_surface(struct wl_client *client, struct wl_resource *resource, uint32_t id) {
+    MockSurface *surface = calloc(1, sizeof(MockSurface));
+    
+    surface->resource = wl_resource_create(client, &wl_surface_interface, wl_resource_get_version(resource), id);
+    surface->scale = 1;
+    surface->pending_opaque = -1;
+    surface->pending_buffer_destroy.notify = surface_buffer_destroyed;
+    wl_list_init(&surface->pending_buffer_destroy.link);
+    wl_list_init(&surface->pending_frames);
+    wl_resource_set_implementation(surface->resource, &surface_impl, surface, surface_free);
+    total.surfaces++;
+}
+
+static void compositor_create_region(struct wl_client *client, struct wl_resource *resource, uint32_t id) {
+    (void)resource;
+    struct wl_resource *region = wl_resource_create(client, &wl_region_interface, 1, id);
+    wl_resource_set_implementation(region, &region_impl, calloc(1, sizeof(long)), region_free);
+}
+
+static const struct wl_compositor_interface compositor_impl = {
+    .create_surface = compositor_create_surface,
+    .create_region = compositor_create_region,
+};
+
+static void bind_compositor(struct wl_client *client, void *data, uint32_t version, uint32_t id) {
+    (void)data;
+    struct wl_resource *resource = wl_resource_create(client, &wl_compositor_interface, version, id);
+    wl_resource_set_implementation(resource, &compositor_impl, NULL, NULL);
+}
+
+// Output -------------------------------------------------------------------
+
+static const struct wl_output_interface output_impl = {
+    .release = resource_destroy,
+};
+
+static void bind_output(struct wl_client *client, void *data, uint32_t version, uint32_t id) {
+    (void)data;
+    struct wl_resource *resource = wl_resource_create(client, &wl_output_interface, version, id);
+    
+    wl_resource_set_implementation(resource, &output_impl, NULL, NULL);
+    wl_output_send_geometry(resource, 0, 0, 600, 340, WL_OUTPUT_SUBPIXEL_UNKNOWN,
+                            "linestatus", "mock", WL_OUTPUT_TRANSFORM_NORMAL);
+    wl_output_send_mode(resource, WL_OUTPUT_MODE_CURRENT | WL_OUTPUT_MODE_PREFERRED,
+                        OUTPUT_WIDTH, OUTPUT_HEIGHT, 60000);
+    if (version >= 2) {
+        wl_output_send_scale(resource, 1);
+        wl_output_send_done(resource);
+    }
+}
+
+// Layer shell --------------------------------------------------------------
+
+static void layer_set_size(struct wl_client *c, struct wl_resource *resource, uint32_t width, uint32_t height) {
+    (void)c;
+    MockSurface *surface = wl_resource_get_user_data(resource);
+    surface->reconfigure |= surface->width != (int)width || surface->height != (int)height;
+    surface->width = width;
+    surface->height = height;
+}
+
+static void layer_set_anchor(struct wl_client *c, struct wl_resource *resource, uint32_t anchor) {
+    (void)c;
+    MockSurface *surface = wl_resource_get_user_data(resource);
+    surface->reconfigure |= surface->anchor != anchor;
+    surface->anchor = anchor;
+}
+
+static void layer_get_popup(struct wl_client *c, struct wl_resource *r, struct wl_resource *popup) {
+    (void)c; (void)r; (void)popup;
+}
+
+static const struct zwlr_layer_surface_v1_interface layer_surface_impl = {
+    .set_size = layer_set_size,
+    .set_anchor = layer_set_anchor,
+    .set_exclusive_zone = ignore_int,
+    .set_margin = ignore_int4,
+    .set_keyboard_interactivity = ignore_uint,
+    .get_popup = layer_get_popup,
+    .ack_configure = ignore_uint,
+    .destroy = resource_destroy,
+    .set_layer = ignore_uint,
+};
+
+// The role object went away; the surface may get a new one
+static void role_free(struct wl_resource *resource) {
+    MockSurface *surface = wl_resource_get_user_data(resource);
+    if (surface) {
+        surface->role = NULL;
+    }
+}
+
+static void layer_shell_get_layer_surface(struct wl_client *client, struct wl_resource *resource, uint32_t id,
+                                          struct wl_resource *surface_resource, struct wl_resource *output,
+                                          uint32_t layer, const char *namespace_) {
+    (void)output; (void)layer; (void)namespace_;
+    MockSurface *surface = wl_resource_get_user_data(surface_resource);
+    
+    surface->role = wl_resource_create(client, &zwlr_layer_surface_v1_interface,
+                                       wl_resource_get_version(resource), id);
+    surface->configured = 0;
+    wl_resource_set_implementation(surface->role, &layer_surface_impl, surface, role_free);
+}
+
+static const struct zwlr_layer_shell_v1_interface layer_shell_impl = {
+    .get_layer_surface = layer_shell_get_layer_surface,
+    .destroy = resource_destroy,
+};
+
+static void bind_layer_shell(struct wl_client *client, void *data, uint32_t version, uint32_t id) {
+    (void)data;
+    struct wl_resource *resource = wl_resource_create(client, &zwlr_layer_shell_v1_interface, version, id);
+    wl_resource_set_implementation(resource, &layer_shell_impl, NULL, NULL);
+}
+
+// xdg-shell (GTK refuses to start without it; toplevels are never shown) ---
+
+static const struct xdg_positioner_interface positioner_impl = {
+    .destroy = resource_destroy,
+    .set_size = ignore_int2,
+    .set_anchor_rect = ignore_int4,
+    .set_anchor = ignore_uint,
+    .set_gravity = ignore_uint,
+    .set_constraint_adjustment = ignore_uint,
+    .set_offset = ignore_int2,
+};
+
+static void toplevel_set_parent(struct wl_client *c, struct wl_resource *r, struct wl_resource *parent) {
+    (void)c; (void)r; (void)parent;
+}
+
+static void toplevel_show_window_menu(struct wl_client *c, struct wl_resource *r, struct wl_resource *seat,
+                                      uint32_t serial_, int32_t x, int32_t y) {
+    (void)c; (void)r; (void)seat; (void)serial_; (void)x; (void)y;
+}
+
+static void toplevel_move(struct wl_client *c, struct wl_resource *r, struct wl_resource *seat, uint32_t serial_) {
+    (void)c; (void)r; (void)seat; (void)serial_;
+}
+
+static void toplevel_resize(struct wl_client *c, struct wl_resource *r, struct wl_resource *seat,
+                            uint32_t serial_, uint32_t edges) {
+    (void)c; (void)r; (void)seat; (void)serial_; (void)edges;
+}
+
+static void toplevel_set_fullscreen(struct wl_client *c, struct wl_resource *r, struct wl_resource *output) {
+    (void)c; (void)r; (void)output;
+}
+
+static const struct xdg_toplevel_interface toplevel_impl = {
+    .destroy = resource_destroy,
+    .set_parent = toplevel_set_parent,
+    .set_title = ignore_string,
+    .set_app_id = ignore_string,
+    .show_window_menu = toplevel_show_window_menu,
+    .move = toplevel_move,
+    .resize = toplevel_resize,
+    .set_max_size = ignore_int2,
+    .set_min_size = ignore_int2,
+    .set_maximized = ignore,
+    .unset_maximized = ignore,
+    .set_fullscreen = toplevel_set_fullscreen,
+    .unset_fullscreen = ignore,
+    .set_minimized = ignore,
+};
+
+static void popup_grab(struct wl_client *c, struct wl_resource *r, struct wl_resource *seat, uint32_t serial_) {
+    (void)c; (void)r; (void)seat; (void)serial_;
+}
+
+static const struct xdg_popup_interface popup_impl = {
+    .destroy = resource_destroy,
+    .grab = popup_grab,
+};
+
+static void xdg_surface_get_toplevel(struct wl_client *client, struct wl_resource *resource, uint32_t id) {
+    struct wl_resource *toplevel = wl_resource_create(client, &xdg_toplevel_interface, 1, id);
+    wl_resource_set_implementation(toplevel, &toplevel_impl, wl_resource_get_user_data(resource), NULL);
+}
+
+static void xdg_surface_get_popup(struct wl_client *client, struct wl_resource *resource, uint32_t id,
+                                  struct wl_resource *parent, struct wl_resource *positioner) {
+    (void)parent; (void)positioner;
+    struct wl_resource *popup = wl_resource_create(client, &xdg_popup_interface, 1, id);
+    wl_resource_set_implementation(popup, &popup_impl, wl_resource_get_user_data(resource), NULL);
+}
+
+static const struct xdg_surface_interface xdg_surface_impl = {
+    .destroy = resource_destroy,
+    .get_toplevel = xdg_surface_get_toplevel,
+    .get_popup = xdg_surface_get_popup,
+    .set_window_geometry = ignore_int4,
+    .ack_configure = ignore_uint,
+};
+
+static void xdg_wm_base_create_positioner(struct wl_client *client, struct wl_resource *resource, uint32_t id) {
+    (void)resource;
+    struct wl_resource *positioner = wl_resource_create(client, &xdg_positioner_interface, 1, id);
+    wl_resource_set_implementation(positioner, &positioner_impl, NULL, NULL);
+}
+
+static void xdg_wm_base_get_xdg_surface(struct wl_client *client, struct wl_resource *resource, uint32_t id,
+                                        struct wl_resource *surface_resource) {
+    (void)resource;
+    MockSurface *surface = wl_resource_get_user_data(surface_resource);
+    
+    surface->role = wl_resource_create(client, &xdg_surface_interface, 1, id);
+    surface->configured = 0;
+    wl_resource_set_implementation(surface->role, &xdg_surface_impl, surface, role_free);
+}
+
+static const struct xdg_wm_base_interface xdg_wm_base_impl = {
+    .destroy = resource_destroy,
+    .create_positioner = xdg_wm_base_create_positioner,
+    .get_xdg_surface = xdg_wm_base_get_xdg_surface,
+    .pong = ignore_uint,
+};
+
+static void bind_xdg_wm_base(struct wl_client *client, void *data, uint32_t version, uint32_t id) {
+    (void)data;
+    struct wl_resource *resource = wl_resource_create(client, &xdg_wm_base_interface, version, id);
+    wl_resource_set_implementation(resource, &xdg_wm_base_impl, NULL, NULL);
+}
+
+static void send_configure(MockSurface *surface) {
+    total.configures++;
+    
+    if (wl_resource_instance_of(surface->role, &zwlr_layer_surface_v1_interface, &layer_surface_impl)) {
+        // Zero means "stretch between the anchored edges"
+        uint32_t width = surface->width ? (uint32_t)surface->width : OUTPUT_WIDTH;
+        uint32_t height = surface->height ? (uint32_t)surface->height : OUTPUT_HEIGHT;
+        zwlr_layer_surface_v1_send_configure(surface->role, serial++, width, height);
+    } else {
+        xdg_surface_send_configure(surface->role, serial++);
+    }
+}
+
+// Main loop ----------------------------------------------------------------
+
+static int on_frame_tick(void *data) {
+    (void)data;
+    struct wl_resource *callback, *tmp;
+    struct timespec now;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint32_t msec = (uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+    wl_resource_for_each_safe(callback, tmp, &frame_callbacks) {
+        wl_callback_send_done(callback, msec);
+        wl_resource_destroy(callback);
+        total.frame_callbacks++;
+    }
+    
+    wl_event_source_timer_update(frame_timer, FRAME_INTERVAL_MS);
+    return 0;
+}
+
+static int on_snapshot(int signal_number, void *data) {
+    (void)signal_number; (void)data;
+    print_counters("delta", &total, &snapshot);
+    snapshot = total;
+    return 0;
+}
+
+static int on_terminate(int signal_number, void *data) {
+    (void)signal_number; (void)data;
+    wl_display_terminate(display);
+    return 0;
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [--socket NAME] [--verbose]\n", prog);
+    printf("  --socket NAME  Wayland socket name in $XDG_RUNTIME_DIR (default: automatic)\n");
+    printf("  --verbose      Print one line per surface commit\n");
+}
+
+int main(int argc, char **argv) {
+    const char *socket_name = NULL;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_name = argv[++i];
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = 1;
+        } else {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    
+    display = wl_display_create();
+    if (socket_name ? wl_display_add_socket(display, socket_name) < 0
+                    : (socket_name = wl_display_add_socket_auto(display)) == NULL) {
+        fprintf(stderr, "Cannot create Wayland socket (is XDG_RUNTIME_DIR set?)\n");
+        return 1;
+    }
+    
+    wl_display_init_shm(display);
+    wl_global_create(display, &wl_compositor_interface, 4, NULL, bind_compositor);
+    wl_global_create(display, &wl_output_interface, 2, NULL, bind_output);
+    wl_global_create(display, &xdg_wm_base_interface, 1, NULL, bind_xdg_wm_base);
+    wl_global_create(display, &zwlr_layer_shell_v1_interface, 4, NULL, bind_layer_shell);
+    wl_list_init(&frame_callbacks);
+    
+    struct wl_event_loop *loop = wl_display_get_event_loop(display);
+    frame_timer = wl_event_loop_add_timer(loop, on_frame_tick, NULL);
+    wl_event_source_timer_update(frame_timer, FRAME_INTERVAL_MS);
+    wl_event_loop_add_signal(loop, SIGUSR1, on_snapshot, NULL);
+    wl_event_loop_add_signal(loop, SIGINT, on_terminate, NULL);
+    wl_event_loop_add_signal(loop, SIGTERM, on_terminate, NULL);
+    
+    printf("mock compositor listening on %s\n", socket_name);
+    fflush(stdout);
+    wl_display_run(display);
+    
+    print_counters("total", &total, &(Counters){0});
+    wl_display_destroy_clients(display);
+    wl_display_destroy(display);
+    return 0;
+}
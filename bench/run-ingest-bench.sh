@@ -0,0 +1,39 @@
+#!/bin/bash
+# Compare the GLib and io_uring ingest backends with ingest-bench.
+# Needs a running Wayland session (linestatus opens its window as usual).
+
+BIN="${BIN:-./linestatus}"
+BENCH="${BENCH:-./ingest-bench}"
+TYPE="bench"
+SOCKET="$XDG_RUNTIME_DIR/linestatus-$TYPE.sock"
+
+if [ ! -x "$BIN" ] || [ ! -x "$BENCH" ]; then
+    echo "Build first: make IO_URING=1 && make bench"
+    exit 1
+fi
+
+run_backend() {
+    local name="$1"
+    shift
+
+    "$BIN" --type "$TYPE" "$@" > /dev/null 2>&1 &
+    local pid=$!
+
+    # Wait for the socket to appear
+    for _ in $(seq 50); do
+        [ -S "$SOCKET" ] && break
+        sleep 0.1
+    done
+
+    echo "== $name =="
+    "$BENCH" --socket "$SOCKET" --key "$TYPE" --mode oneshot --concurrency 16 --count 20000
+    "$BENCH" --socket "$SOCKET" --key "$TYPE" --mode oneshot --concurrency 64 --count 20000
+    "$BENCH" --socket "$SOCKET" --key "$TYPE" --mode stream --concurrency 100 --count 2000
+    "$BENCH" --socket "$SOCKET" --key "$TYPE" --mode stream --concurrency 4 --count 2000 --segments 128 --stats
+
+    kill "$pid"
+    wait "$pid" 2> /dev/null
+}
+
+run_backend "GLib (epoll)"
+run_backend "io_uring" --io-uring
@@ -0,0 +1,57 @@
+#!/bin/bash
+# Compositor-side cost per update: run linestatus on the mock compositor,
+# send a paced series of updates and report commits, buffer bytes, damage
+# and frame callbacks per update. Runs headless (no display needed).
+#
+# Build first: make && make mock
+
+BIN="${BIN:-./linestatus}"
+MOCK="${MOCK:-./mock-compositor}"
+UPDATES="${UPDATES:-200}"
+INTERVAL="${INTERVAL:-0.02}"    # Seconds between updates, slower than a frame
+TYPE="mock"
+export XDG_RUNTIME_DIR="${XDG_RUNTIME_DIR:-/tmp/linestatus-mock-$$}"
+mkdir -p -m 700 "$XDG_RUNTIME_DIR"
+SOCKET="$XDG_RUNTIME_DIR/linestatus-$TYPE.sock"
+DISPLAY_NAME="linestatus-mock-$$"
+LOG="$XDG_RUNTIME_DIR/mock-compositor-$$.log"
+
+if [ ! -x "$BIN" ] || [ ! -x "$MOCK" ]; then
+    echo "Build first: make && make mock"
+    exit 1
+fi
+
+"$MOCK" --socket "$DISPLAY_NAME" > "$LOG" &
+MOCK_PID=$!
+for _ in $(seq 50); do
+    [ -S "$XDG_RUNTIME_DIR/$DISPLAY_NAME" ] && break
+    sleep 0.1
+done
+
+WAYLAND_DISPLAY="$DISPLAY_NAME" GDK_BACKEND=wayland "$BIN" --type "$TYPE" --quiet "$@" > /dev/null 2>&1 &
+PID=$!
+for _ in $(seq 50); do
+    [ -S "$SOCKET" ] && break
+    sleep 0.1
+done
+sleep 0.5
+
+# Startup (mapping, first frames) is not part of the per-update numbers
+kill -USR1 "$MOCK_PID"
+for i in $(seq "$UPDATES"); do
+    echo "$TYPE:$((i % 101))" | socat - UNIX-CONNECT:"$SOCKET"
+    sleep "$INTERVAL"
+done
+sleep 0.2
+kill -USR1 "$MOCK_PID"
+sleep 0.1
+
+kill "$PID"
+wait "$PID" 2> /dev/null
+kill "$MOCK_PID"
+wait "$MOCK_PID" 2> /dev/null
+
+# The second "delta" line covers exactly the update series
+grep '^delta' "$LOG" | tail -n 1 | tr ' ' '\n' | awk -F= -v n="$UPDATES" '
+    NF == 2 { printf "%-16s %10d  %10.1f per update\n", $1, $2, $2 / n }'
+rm -f "$LOG"
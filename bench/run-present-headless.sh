@@ -0,0 +1,38 @@
+#!/bin/bash
+# Measure receive -> screen and send -> screen latency on a headless
+# compositor. Weston's headless backend implements wp_presentation, so the
+# "present_latency_us" and "end_to_end_us" stats are filled in without a
+# display. Needs weston, a built linestatus and ingest-bench.
+
+BIN="${BIN:-./linestatus}"
+BENCH="${BENCH:-./ingest-bench}"
+TYPE="present"
+export XDG_RUNTIME_DIR="${XDG_RUNTIME_DIR:-/tmp/linestatus-present-$$}"
+mkdir -p -m 700 "$XDG_RUNTIME_DIR"
+SOCKET="$XDG_RUNTIME_DIR/linestatus-$TYPE.sock"
+DISPLAY_NAME="linestatus-headless-$$"
+
+if [ ! -x "$BIN" ] || [ ! -x "$BENCH" ]; then
+    echo "Build first: make && make bench"
+    exit 1
+fi
+
+weston --backend=headless --socket="$DISPLAY_NAME" --idle-time=0 > /dev/null 2>&1 &
+WESTON_PID=$!
+for _ in $(seq 50); do
+    [ -S "$XDG_RUNTIME_DIR/$DISPLAY_NAME" ] && break
+    sleep 0.1
+done
+
+WAYLAND_DISPLAY="$DISPLAY_NAME" "$BIN" --type "$TYPE" --quiet > /dev/null 2>&1 &
+PID=$!
+for _ in $(seq 50); do
+    [ -S "$SOCKET" ] && break
+    sleep 0.1
+done
+
+# Paced stream so most values get their own frame
+"$BENCH" --socket "$SOCKET" --key "$TYPE" --mode oneshot --concurrency 1 --count 500 --timestamp --stats
+
+kill "$PID" "$WESTON_PID"
+wait 2> /dev/null
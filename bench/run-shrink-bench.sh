@@ -0,0 +1,13 @@
+#!/bin/bash
+# Full-length surface vs --shrink on the mock compositor: buffer bytes per
+# commit and the area the compositor still has to blend (buffer area minus
+# the declared opaque region). Runs headless like run-mock-compositor.sh.
+#
+# Build first: make && make mock
+
+DIR="$(dirname "$0")"
+
+echo "== full length =="
+"$DIR/run-mock-compositor.sh" "$@"
+echo "== --shrink =="
+"$DIR/run-mock-compositor.sh" --shrink "$@"
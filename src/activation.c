@@ -0,0 +1,52 @@
+#define _GNU_SOURCE
+#include "activation.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+
+#include "log.h"
+
+// Only a listening stream socket is any use to ingest
+static int is_listening_socket(int fd) {
+    int listening = 0, type = 0;
+    socklen_t len = sizeof(listening);
+    
+    if (getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &listening, &len) < 0) {
+        return 0;
+    }
+    len = sizeof(type);
+    if (getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len) < 0) {
+        return 0;
+    }
+    return listening && type == SOCK_STREAM;
+}
+
+int activation_listen_fd(int fd_arg) {
+    const char *pid_env = getenv("LISTEN_PID");
+    const char *fds_env = getenv("LISTEN_FDS");
+    int fd = fd_arg;
+    
+    if (fd < 0 && pid_env != NULL && fds_env != NULL &&
+        strtol(pid_env, NULL, 10) == (long)getpid() && strtol(fds_env, NULL, 10) >= 1) {
+        fd = ACTIVATION_FIRST_FD;
+    }
+    unsetenv("LISTEN_PID");
+    unsetenv("LISTEN_FDS");
+    unsetenv("LISTEN_FDNAMES");
+    
+    if (fd < 0) {
+        return -1;
+    }
+    if (!is_listening_socket(fd)) {
+        log_warn("⚠️  fd %d is not a listening stream socket, creating our own\n", fd);
+        return -1;
+    }
+    
+    // Not for source commands we spawn
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    log_info("🔌 Using inherited listening socket (fd %d)\n", fd);
+    return fd;
+}
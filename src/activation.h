@@ -0,0 +1,22 @@
+/*
+ * Socket activation.
+ *
+ * A service manager can create the listening socket itself and start
+ * linestatus on the first connection (systemd .socket units and anything
+ * else speaking the LISTEN_FDS protocol), or a wrapper can pass an
+ * already listening socket with --listen-fd N. Connections that arrive
+ * before the window is up wait in the socket's backlog, so no update is
+ * lost while GTK starts.
+ */
+
+#ifndef ACTIVATION_H
+#define ACTIVATION_H
+
+#define ACTIVATION_FIRST_FD 3   // SD_LISTEN_FDS_START
+
+// Listening socket to use instead of creating one: fd_arg if >= 0, else the
+// first socket from LISTEN_FDS (if LISTEN_PID is us), else -1. The LISTEN_*
+// variables are removed so child processes do not pick them up.
+int activation_listen_fd(int fd_arg);
+
+#endif /* ACTIVATION_H */
@@ -0,0 +1,211 @@
+#include "activity.h"
+
+#include <gdk/wayland/gdkwayland.h>
+#include <string.h>
+#include <wayland-client.h>
+
+#include "ext-idle-notify-v1-client-protocol.h"
+#include "wlr-output-power-management-unstable-v1-client-protocol.h"
+
+#include "log.h"
+
+typedef struct {
+    struct zwlr_output_power_v1 *power;
+    gboolean on;
+} OutputPower;
+
+static ActivityChangedFunc changed_func = NULL;
+static gpointer changed_data = NULL;
+static struct ext_idle_notifier_v1 *idle_notifier = NULL;
+static struct ext_idle_notification_v1 *idle_notification = NULL;
+static struct zwlr_output_power_manager_v1 *power_manager = NULL;
+static GPtrArray *output_powers = NULL; // OutputPower *, one per output
+static GListModel *watched_list = NULL;
+static gboolean idle = FALSE;
+static gboolean active = TRUE;
+
+static void update_active(void) {
+    gboolean any_on = output_powers == NULL || output_powers->len == 0;
+    
+    for (guint i = 0; output_powers != NULL && i < output_powers->len; i++) {
+        any_on |= ((OutputPower *)g_ptr_array_index(output_powers, i))->on;
+    }
+    if (active == (!idle && any_on)) {
+        return;
+    }
+    
+    active = !idle && any_on;
+    if (active) {
+        log_info("▶️  Rendering resumed\n");
+    } else {
+        log_info("⏸️  Rendering paused (%s)\n", idle ? "idle" : "outputs off");
+    }
+    if (changed_func != NULL) {
+        changed_func(active, changed_data);
+    }
+}
+
+static void on_idled(void *data, struct ext_idle_notification_v1 *notification) {
+    (void)data; (void)notification;
+    idle = TRUE;
+    update_active();
+}
+
+static void on_resumed(void *data, struct ext_idle_notification_v1 *notification) {
+    (void)data; (void)notification;
+    idle = FALSE;
+    update_active();
+}
+
+static const struct ext_idle_notification_v1_listener idle_listener = {
+    .idled = on_idled,
+    .resumed = on_resumed,
+};
+
+static void on_power_mode(void *data, struct zwlr_output_power_v1 *power, uint32_t mode) {
+    OutputPower *output = data;
+    (void)power;
+    output->on = mode == ZWLR_OUTPUT_POWER_V1_MODE_ON;
+    update_active();
+}
+
+// Another client controls the output or it went away: treat it as on
+static void on_power_failed(void *data, struct zwlr_output_power_v1 *power) {
+    OutputPower *output = data;
+    zwlr_output_power_v1_destroy(power);
+    output->power = NULL;
+    output->on = TRUE;
+    update_active();
+}
+
+static const struct zwlr_output_power_v1_listener power_listener = {
+    .mode = on_power_mode,
+    .failed = on_power_failed,
+};
+
+static void output_power_free(OutputPower *output) {
+    if (output->power != NULL) {
+        zwlr_output_power_v1_destroy(output->power);
+    }
+    g_free(output);
+}
+
+// One power mode listener per current output
+static void watch_output_power(void) {
+    g_ptr_array_set_size(output_powers, 0);
+    for (guint i = 0; i < g_list_model_get_n_items(watched_list); i++) {
+        GdkMonitor *monitor = g_list_model_get_item(watched_list, i);
+        OutputPower *output = g_new0(OutputPower, 1);
+        output->on = TRUE; // Until the compositor says otherwise
+        output->power = zwlr_output_power_manager_v1_get_output_power(power_manager,
+                                                                      gdk_wayland_monitor_get_wl_output(monitor));
+        zwlr_output_power_v1_add_listener(output->power, &power_listener, output);
+        g_ptr_array_add(output_powers, output);
+        g_object_unref(monitor);
+    }
+    update_active();
+}
+
+static void on_monitors_changed(GListModel *list, guint position, guint removed, guint added, gpointer data) {
+    (void)list; (void)position; (void)removed; (void)added; (void)data;
+    watch_output_power();
+}
+
+static void on_global(void *data, struct wl_registry *registry, uint32_t name, const char *interface, uint32_t version) {
+    (void)data; (void)version;
+    if (strcmp(interface, ext_idle_notifier_v1_interface.name) == 0) {
+        idle_notifier = wl_registry_bind(registry, name, &ext_idle_notifier_v1_interface, 1);
+    } else if (strcmp(interface, zwlr_output_power_manager_v1_interface.name) == 0) {
+        power_manager = wl_registry_bind(registry, name, &zwlr_output_power_manager_v1_interface, 1);
+    }
+}
+
+static void on_global_remove(void *data, struct wl_registry *registry, uint32_t name) {
+    (void)data; (void)registry; (void)name;
+}
+
+static const struct wl_registry_listener registry_listener = {
+    .global = on_global,
+    .global_remove = on_global_remove,
+};
+
+// Look the globals up on a private queue so GDK's own events are not
+// dispatched from here, then hand the bound objects to GDK's queue
+static void bind_globals(struct wl_display *display) {
+    struct wl_event_queue *queue = wl_display_create_queue(display);
+    struct wl_display *wrapper = wl_proxy_create_wrapper(display);
+    
+    wl_proxy_set_queue((struct wl_proxy *)wrapper, queue);
+    struct wl_registry *registry = wl_display_get_registry(wrapper);
+    wl_registry_add_listener(registry, &registry_listener, NULL);
+    wl_display_roundtrip_queue(display, queue);
+    wl_registry_destroy(registry);
+    wl_proxy_wrapper_destroy(wrapper);
+    
+    if (idle_notifier != NULL) {
+        wl_proxy_set_queue((struct wl_proxy *)idle_notifier, NULL);
+    }
+    if (power_manager != NULL) {
+        wl_proxy_set_queue((struct wl_proxy *)power_manager, NULL);
+    }
+    wl_event_queue_destroy(queue);
+}
+
+void activity_watch(guint idle_timeout_ms, ActivityChangedFunc func, gpointer user_data) {
+    GdkDisplay *gdk_display = gdk_display_get_default();
+    
+    activity_unwatch();
+    if (gdk_display == NULL || !GDK_IS_WAYLAND_DISPLAY(gdk_display)) {
+        return;
+    }
+    changed_func = func;
+    changed_data = user_data;
+    bind_globals(gdk_wayland_display_get_wl_display(gdk_display));
+    
+    if (idle_timeout_ms > 0 && idle_notifier != NULL) {
+        struct wl_seat *seat = gdk_wayland_seat_get_wl_seat(gdk_display_get_default_seat(gdk_display));
+        idle_notification = ext_idle_notifier_v1_get_idle_notification(idle_notifier, idle_timeout_ms, seat);
+        ext_idle_notification_v1_add_listener(idle_notification, &idle_listener, NULL);
+    } else if (idle_timeout_ms > 0) {
+        log_warn("⚠️  Compositor has no ext-idle-notify-v1, not pausing when idle\n");
+    }
+    
+    if (power_manager != NULL) {
+        output_powers = g_ptr_array_new_with_free_func((GDestroyNotify)output_power_free);
+        watched_list = gdk_display_get_monitors(gdk_display);
+        g_signal_connect(watched_list, "items-changed", G_CALLBACK(on_monitors_changed), NULL);
+        watch_output_power();
+    } else {
+        log_debug("No wlr-output-power-management, output power is not followed\n");
+    }
+}
+
+gboolean activity_is_active(void) {
+    return active;
+}
+
+void activity_unwatch(void) {
+    if (watched_list != NULL) {
+        g_signal_handlers_disconnect_by_func(watched_list, on_monitors_changed, NULL);
+        watched_list = NULL;
+    }
+    if (output_powers != NULL) {
+        g_ptr_array_free(output_powers, TRUE);
+        output_powers = NULL;
+    }
+    if (idle_notification != NULL) {
+        ext_idle_notification_v1_destroy(idle_notification);
+        idle_notification = NULL;
+    }
+    if (idle_notifier != NULL) {
+        ext_idle_notifier_v1_destroy(idle_notifier);
+        idle_notifier = NULL;
+    }
+    if (power_manager != NULL) {
+        zwlr_output_power_manager_v1_destroy(power_manager);
+        power_manager = NULL;
+    }
+    idle = FALSE;
+    active = TRUE;
+    changed_func = NULL;
+}
@@ -0,0 +1,33 @@
+/*
+ * Session activity - is anybody looking?
+ *
+ * While the user is idle or every output is powered off, producers keep
+ * sending values but nobody sees the frames we would draw for them. The
+ * compositor tells us both through Wayland protocols GTK does not wrap:
+ * ext-idle-notify-v1 (idle after a timeout, resumed on input) and
+ * wlr-output-power-management-unstable-v1 (per output power mode). They
+ * are bound on GDK's own connection, so their events are dispatched by
+ * the GTK main loop like everything else.
+ *
+ * Without those globals (or on a non-Wayland display) the session always
+ * counts as active.
+ */
+
+#ifndef ACTIVITY_H
+#define ACTIVITY_H
+
+#include <glib.h>
+
+// Called on the GTK thread when rendering should pause (FALSE) or resume (TRUE)
+typedef void (*ActivityChangedFunc)(gboolean active, gpointer user_data);
+
+// Start listening. idle_timeout_ms is the input inactivity after which the
+// session counts as idle, 0 to follow output power only.
+void activity_watch(guint idle_timeout_ms, ActivityChangedFunc func, gpointer user_data);
+
+// FALSE while the session is idle or all outputs are off
+gboolean activity_is_active(void);
+
+void activity_unwatch(void);
+
+#endif /* ACTIVITY_H */
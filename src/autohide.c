@@ -0,0 +1,71 @@
+#include "autohide.h"
+
+#include <stdlib.h>
+
+static void arm(AutoHide *hide, guint delay_ms);
+
+// Fires at the earliest possible hide time; updates that came in meanwhile push it back
+static gboolean on_hide_timeout(gpointer data) {
+    AutoHide *hide = data;
+    gint64 idle_ms = (g_get_monotonic_time() - hide->last_update) / 1000;
+    
+    hide->timer_id = 0;
+    if (idle_ms < hide->timeout_ms) {
+        arm(hide, hide->timeout_ms - (guint)idle_ms);
+        return G_SOURCE_REMOVE;
+    }
+    
+    hide->hidden = TRUE;
+    hide->func(FALSE, hide->user_data);
+    return G_SOURCE_REMOVE;
+}
+
+static void arm(AutoHide *hide, guint delay_ms) {
+    hide->timer_id = g_timeout_add(delay_ms, on_hide_timeout, hide);
+}
+
+void autohide_init(AutoHide *hide, guint timeout_ms, AutoHideFunc func, gpointer user_data) {
+    hide->timeout_ms = timeout_ms;
+    hide->last_update = g_get_monotonic_time();
+    hide->timer_id = 0;
+    hide->hidden = FALSE;
+    hide->func = func;
+    hide->user_data = user_data;
+    if (timeout_ms > 0) {
+        arm(hide, timeout_ms);
+    }
+}
+
+void autohide_touch(AutoHide *hide) {
+    if (hide->timeout_ms == 0) {
+        return;
+    }
+    
+    // Hot path: a timestamp, no timer churn per update
+    hide->last_update = g_get_monotonic_time();
+    if (hide->hidden) {
+        hide->hidden = FALSE;
+        hide->func(TRUE, hide->user_data);
+    }
+    if (hide->timer_id == 0) {
+        arm(hide, hide->timeout_ms);
+    }
+}
+
+void autohide_clear(AutoHide *hide) {
+    if (hide->timer_id != 0) {
+        g_source_remove(hide->timer_id);
+        hide->timer_id = 0;
+    }
+}
+
+gboolean autohide_parse_timeout(const char *str, guint *timeout_ms) {
+    char *end = NULL;
+    double seconds = g_ascii_strtod(str, &end);
+    
+    if (end == str || *end != '\0' || seconds < 0 || seconds > 86400) {
+        return FALSE;
+    }
+    *timeout_ms = (guint)(seconds * 1000 + 0.5);
+    return TRUE;
+}
@@ -0,0 +1,44 @@
+/*
+ * Auto-hide after inactivity.
+ *
+ * An indicator is only interesting right after its value changed. With a
+ * timeout set, it is hidden once no update arrived for that long: the
+ * window is unmapped, which destroys the layer surface and lets the
+ * compositor drop it from composition and release its buffers. The next
+ * update maps it again, drawn with the latest value on the first frame.
+ *
+ * Updates only store a timestamp; a single timer is armed while shown and
+ * re-armed for the remaining time when it fires early. Nothing runs while
+ * hidden.
+ */
+
+#ifndef AUTOHIDE_H
+#define AUTOHIDE_H
+
+#include <glib.h>
+
+// Called when the element should be shown (TRUE) or hidden (FALSE)
+typedef void (*AutoHideFunc)(gboolean visible, gpointer user_data);
+
+typedef struct {
+    guint timeout_ms;           // 0 disables auto-hide
+    gint64 last_update;         // Monotonic time of the latest update
+    guint timer_id;             // Pending hide check, 0 while hidden
+    gboolean hidden;
+    AutoHideFunc func;
+    gpointer user_data;
+} AutoHide;
+
+// Start in the shown state with the timer armed (nothing happens if timeout_ms is 0)
+void autohide_init(AutoHide *hide, guint timeout_ms, AutoHideFunc func, gpointer user_data);
+
+// A new value arrived: show again if hidden and restart the countdown
+void autohide_touch(AutoHide *hide);
+
+// Cancel the timer, e.g. before the element is freed
+void autohide_clear(AutoHide *hide);
+
+// Parse a timeout in seconds ("5", "0.5") into milliseconds
+gboolean autohide_parse_timeout(const char *str, guint *timeout_ms);
+
+#endif /* AUTOHIDE_H */
@@ -0,0 +1,204 @@
+#include "bus.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "log.h"
+#include "values.h"
+
+static const char bus_introspection[] =
+    "<node>"
+    "  <interface name='" BUS_INTERFACE "'>"
+    "    <method name='SetValue'>"
+    "      <arg type='s' name='key' direction='in'/>"
+    "      <arg type='d' name='percent' direction='in'/>"
+    "    </method>"
+    "    <method name='SetValues'>"
+    "      <arg type='a{sad}' name='values' direction='in'/>"
+    "    </method>"
+    "    <method name='Adjust'>"
+    "      <arg type='s' name='key' direction='in'/>"
+    "      <arg type='d' name='delta' direction='in'/>"
+    "      <arg type='d' name='percent' direction='out'/>"
+    "    </method>"
+    "    <property name='Values' type='a{sad}' access='read'/>"
+    "  </interface>"
+    "</node>";
+
+static GDBusConnection *bus_connection = NULL;
+static char *bus_path = NULL;
+static const char *bus_default_key = NULL;
+static BusSubmitFunc bus_submit = NULL;
+static guint registration_id = 0;
+
+// Empty means the default key; NULL if the key is not usable
+static const char *resolve_key(const char *key) {
+    if (*key == '\0') {
+        key = bus_default_key;
+    }
+    return protocol_valid_key(key) ? key : NULL;
+}
+
+static void submit_value(const char *key, int index, double percent) {
+    Update update = {0};
+    
+    g_strlcpy(update.key, key, sizeof(update.key));
+    update.index = index;
+    update.value = fmax(0.0, fmin(1.0, percent / 100.0));
+    update.received = g_get_monotonic_time();
+    bus_submit(&update);
+}
+
+static void add_key_values(const char *key, const float *values, int count, gpointer user_data) {
+    GVariantBuilder *builder = user_data;
+    GVariantBuilder percents;
+    
+    g_variant_builder_init(&percents, G_VARIANT_TYPE("ad"));
+    for (int i = 0; i < count; i++) {
+        g_variant_builder_add(&percents, "d", values[i] * 100.0);
+    }
+    g_variant_builder_add(builder, "{sad}", key, &percents);
+}
+
+static GVariant *values_variant(void) {
+    GVariantBuilder builder;
+    
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sad}"));
+    values_foreach(add_key_values, &builder);
+    return g_variant_builder_end(&builder);
+}
+
+static void set_values(GVariant *parameters, GDBusMethodInvocation *invocation) {
+    GVariantIter *iter;
+    GVariantIter *percents;
+    const char *key;
+    int rejected = 0;
+    
+    g_variant_get(parameters, "(a{sad})", &iter);
+    while (g_variant_iter_loop(iter, "{&sad}", &key, &percents)) {
+        const char *resolved = resolve_key(key);
+        double percent;
+        int index = 0;
+        
+        if (resolved == NULL) {
+            rejected++;
+            continue;
+        }
+        while (index < UPDATE_SEGMENTS_MAX && g_variant_iter_next(percents, "d", &percent)) {
+            submit_value(resolved, index++, percent);
+        }
+    }
+    g_variant_iter_free(iter);
+    
+    if (rejected > 0) {
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS,
+                                              "%d invalid key%s ignored", rejected, rejected == 1 ? "" : "s");
+        return;
+    }
+    g_dbus_method_invocation_return_value(invocation, NULL);
+}
+
+static void on_method_call(GDBusConnection *connection, const gchar *sender, const gchar *object_path,
+                           const gchar *interface_name, const gchar *method_name, GVariant *parameters,
+                           GDBusMethodInvocation *invocation, gpointer user_data) {
+    (void)connection; (void)sender; (void)object_path; (void)interface_name; (void)user_data;
+    const char *key;
+    const char *resolved;
+    double number;
+    
+    if (strcmp(method_name, "SetValues") == 0) {
+        set_values(parameters, invocation);
+        return;
+    }
+    
+    // SetValue and Adjust: (sd)
+    g_variant_get(parameters, "(&sd)", &key, &number);
+    if ((resolved = resolve_key(key)) == NULL) {
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS,
+                                              "Invalid key '%s'", key);
+        return;
+    }
+    
+    if (strcmp(method_name, "SetValue") == 0) {
+        submit_value(resolved, 0, number);
+        g_dbus_method_invocation_return_value(invocation, NULL);
+        return;
+    }
+    
+    // Adjust: relative to the latest value, including ones not drawn yet
+    float current;
+    if (!values_lookup(resolved, 0, &current)) {
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS,
+                                              "No value for '%s' yet", resolved);
+        return;
+    }
+    double percent = fmax(0.0, fmin(100.0, current * 100.0 + number));
+    submit_value(resolved, 0, percent);
+    g_dbus_method_invocation_return_value(invocation, g_variant_new("(d)", percent));
+}
+
+static GVariant *on_get_property(GDBusConnection *connection, const gchar *sender, const gchar *object_path,
+                                 const gchar *interface_name, const gchar *property_name,
+                                 GError **error, gpointer user_data) {
+    (void)connection; (void)sender; (void)object_path; (void)interface_name; (void)property_name;
+    (void)error; (void)user_data;
+    return values_variant(); // Values is the only property
+}
+
+static const GDBusInterfaceVTable bus_vtable = {
+    on_method_call, on_get_property, NULL, { NULL }
+};
+
+// Coalesced by the values store to one call per notification interval
+static void on_values_changed(gpointer user_data) {
+    (void)user_data;
+    GVariantBuilder changed;
+    
+    g_variant_builder_init(&changed, G_VARIANT_TYPE("a{sv}"));
+    g_variant_builder_add(&changed, "{sv}", "Values", values_variant());
+    g_dbus_connection_emit_signal(bus_connection, NULL, bus_path, "org.freedesktop.DBus.Properties",
+                                  "PropertiesChanged",
+                                  g_variant_new("(sa{sv}as)", BUS_INTERFACE, &changed, NULL), NULL);
+}
+
+gboolean bus_export(GDBusConnection *connection, const char *object_path,
+                    const char *default_key, BusSubmitFunc submit) {
+    GError *error = NULL;
+    GDBusNodeInfo *info = g_dbus_node_info_new_for_xml(bus_introspection, &error);
+    
+    if (info == NULL) {
+        log_warn("⚠️  Bad D-Bus introspection data: %s\n", error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+    
+    registration_id = g_dbus_connection_register_object(connection, object_path, info->interfaces[0],
+                                                        &bus_vtable, NULL, NULL, &error);
+    g_dbus_node_info_unref(info);
+    if (registration_id == 0) {
+        log_warn("⚠️  Failed to export %s at %s: %s\n", BUS_INTERFACE, object_path, error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+    
+    bus_connection = g_object_ref(connection);
+    bus_path = g_strdup(object_path);
+    bus_default_key = default_key;
+    bus_submit = submit;
+    values_set_listener(on_values_changed, NULL);
+    log_info("🚌 D-Bus interface %s at %s\n", BUS_INTERFACE, object_path);
+    return TRUE;
+}
+
+void bus_unexport(void) {
+    if (registration_id == 0) {
+        return;
+    }
+    values_set_listener(NULL, NULL);
+    g_dbus_connection_unregister_object(bus_connection, registration_id);
+    registration_id = 0;
+    g_object_unref(bus_connection);
+    bus_connection = NULL;
+    g_free(bus_path);
+    bus_path = NULL;
+}
@@ -0,0 +1,38 @@
+/*
+ * Session bus interface - com.linestatus.Indicator.
+ *
+ * Exported (with --dbus) on the object path of the application's
+ * com.linestatus.<type> name, for desktop components that already hold a
+ * bus connection and would rather not open sockets or spawn helpers:
+ *
+ *   SetValue(s key, d percent)
+ *   SetValues(a{sad} values)        several keys, one array entry per segment
+ *   Adjust(s key, d delta) -> d     relative change, returns the new percent
+ *   Values: a{sad}                  read-only property, PropertiesChanged at
+ *                                   most once per frame
+ *
+ * An empty key means the instance's default key. Values go through the
+ * same ingest path as socket updates (coalescing, stats, get/subscribe).
+ * The object is registered from the ingest thread, so GDBus dispatches the
+ * calls there as well.
+ */
+
+#ifndef BUS_H
+#define BUS_H
+
+#include <gio/gio.h>
+
+#include "protocol.h"
+
+#define BUS_INTERFACE "com.linestatus.Indicator"
+
+// Receives every value set over the bus (runs on the exporting thread)
+typedef void (*BusSubmitFunc)(const Update *update);
+
+// Export the interface at object_path on the calling thread's default context
+gboolean bus_export(GDBusConnection *connection, const char *object_path,
+                    const char *default_key, BusSubmitFunc submit);
+
+void bus_unexport(void);
+
+#endif /* BUS_H */
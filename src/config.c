@@ -0,0 +1,250 @@
+#define _GNU_SOURCE
+#include "config.h"
+
+#include <glib-unix.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/inotify.h>
+
+#include "log.h"
+
+// The watched file (one per process)
+static char *watch_path = NULL;
+static char *watch_name = NULL;
+static char *watch_type = NULL;
+static int watch_fd = -1;
+static GSource *watch_source = NULL;
+static ConfigChangedFunc watch_func = NULL;
+static gpointer watch_data = NULL;
+
+char *config_default_path(const char *type) {
+    char *name = g_strdup_printf("%s.conf", type);
+    char *path = g_build_filename(g_get_user_config_dir(), "linestatus", name, NULL);
+    g_free(name);
+    
+    if (!g_file_test(path, G_FILE_TEST_EXISTS)) {
+        g_free(path);
+        path = g_build_filename(g_get_user_config_dir(), "linestatus", "linestatus.conf", NULL);
+    }
+    return path;
+}
+
+gboolean config_parse_color(const char *str, double *r, double *g, double *b) {
+    unsigned int red, green, blue;
+    
+    if (str[0] == '#') {
+        str++;
+    }
+    if (strlen(str) != 6 || sscanf(str, "%02x%02x%02x", &red, &green, &blue) != 3) {
+        return FALSE;
+    }
+    *r = red / 255.0;
+    *g = green / 255.0;
+    *b = blue / 255.0;
+    return TRUE;
+}
+
+// Apply the keys of one group; later groups override earlier ones
+static void config_load_group(GKeyFile *file, const char *group, const char *path, ConfigSettings *settings) {
+    char *value;
+    
+    if (!g_key_file_has_group(file, group)) {
+        return;
+    }
+    
+    if ((value = g_key_file_get_string(file, group, "color", NULL)) != NULL) {
+        if (config_parse_color(g_strstrip(value), &settings->r, &settings->g, &settings->b)) {
+            settings->set |= CONFIG_COLOR;
+        } else {
+            log_warn("⚠️  %s [%s]: invalid color '%s'\n", path, group, value);
+        }
+        g_free(value);
+    }
+    
+    if ((value = g_key_file_get_string(file, group, "position", NULL)) != NULL) {
+        int x, y;
+        g_strstrip(value);
+        if (strcmp(value, "auto") == 0) {
+            settings->x = -1;
+            settings->y = 0;
+            settings->set |= CONFIG_POSITION;
+        } else if (sscanf(value, "%d,%d", &x, &y) == 2 && x >= 0 && y >= 0) {
+            settings->x = x;
+            settings->y = y;
+            settings->set |= CONFIG_POSITION;
+        } else {
+            log_warn("⚠️  %s [%s]: position must be X,Y or auto\n", path, group);
+        }
+        g_free(value);
+    }
+    
+    if ((value = g_key_file_get_string(file, group, "orientation", NULL)) != NULL) {
+        g_strstrip(value);
+        if (strcmp(value, "vertical") == 0 || strcmp(value, "horizontal") == 0) {
+            settings->vertical = strcmp(value, "vertical") == 0;
+            settings->set |= CONFIG_ORIENTATION;
+        } else {
+            log_warn("⚠️  %s [%s]: orientation must be vertical or horizontal\n", path, group);
+        }
+        g_free(value);
+    }
+    
+    if (g_key_file_has_key(file, group, "thickness", NULL)) {
+        GError *error = NULL;
+        int thickness = g_key_file_get_integer(file, group, "thickness", &error);
+        if (error == NULL && thickness > 0) {
+            settings->thickness = thickness;
+            settings->set |= CONFIG_THICKNESS;
+        } else {
+            log_warn("⚠️  %s [%s]: thickness must be a positive number of pixels\n", path, group);
+            g_clear_error(&error);
+        }
+    }
+}
+
+gboolean config_load(const char *path, const char *type, ConfigSettings *settings) {
+    GKeyFile *file = g_key_file_new();
+    GError *error = NULL;
+    
+    memset(settings, 0, sizeof(*settings));
+    if (!g_key_file_load_from_file(file, path, G_KEY_FILE_NONE, &error)) {
+        gboolean missing = g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+        if (!missing) {
+            log_warn("⚠️  Cannot load config %s: %s\n", path, error->message);
+        }
+        g_error_free(error);
+        g_key_file_free(file);
+        return missing;
+    }
+    
+    config_load_group(file, "default", path, settings);
+    config_load_group(file, type, path, settings);
+    g_key_file_free(file);
+    return TRUE;
+}
+
+void config_merge(ConfigSettings *base, const ConfigSettings *file, guint locked) {
+    guint fields = file->set & ~locked;
+    
+    if (fields & CONFIG_COLOR) {
+        base->r = file->r;
+        base->g = file->g;
+        base->b = file->b;
+    }
+    if (fields & CONFIG_POSITION) {
+        base->x = file->x;
+        base->y = file->y;
+    }
+    if (fields & CONFIG_ORIENTATION) {
+        base->vertical = file->vertical;
+    }
+    if (fields & CONFIG_THICKNESS) {
+        base->thickness = file->thickness;
+    }
+}
+
+guint config_diff(const ConfigSettings *a, const ConfigSettings *b) {
+    guint changed = 0;
+    
+    if (a->r != b->r || a->g != b->g || a->b != b->b) {
+        changed |= CONFIG_COLOR;
+    }
+    if (a->x != b->x || a->y != b->y) {
+        changed |= CONFIG_POSITION;
+    }
+    if (a->vertical != b->vertical) {
+        changed |= CONFIG_ORIENTATION;
+    }
+    if (a->thickness != b->thickness) {
+        changed |= CONFIG_THICKNESS;
+    }
+    return changed;
+}
+
+void config_reload(void) {
+    ConfigSettings settings;
+    
+    if (watch_path == NULL) {
+        return;
+    }
+    // A half-written or broken file keeps what is on screen
+    if (config_load(watch_path, watch_type, &settings)) {
+        log_info("🔄 Reloaded config %s\n", watch_path);
+        watch_func(&settings, watch_data);
+    }
+}
+
+static gboolean config_file_changed(gint fd, GIOCondition condition, gpointer user_data) {
+    (void)condition; (void)user_data;
+    
+    // Drain every queued event and reload at most once per wakeup
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    gboolean changed = FALSE;
+    ssize_t len;
+    
+    while ((len = read(fd, events, sizeof(events))) > 0) {
+        for (char *p = events; p < events + len; ) {
+            struct inotify_event *event = (struct inotify_event *)p;
+            if (event->len > 0 && strcmp(event->name, watch_name) == 0) {
+                changed = TRUE;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    
+    if (changed) {
+        config_reload();
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+gboolean config_watch(const char *path, const char *type, ConfigChangedFunc func, gpointer user_data) {
+    config_unwatch();
+    watch_path = g_strdup(path);
+    watch_name = g_path_get_basename(path);
+    watch_type = g_strdup(type);
+    watch_func = func;
+    watch_data = user_data;
+    
+    // Watch the directory rather than the file so atomic replaces, creation
+    // and removal of the file are seen as well as in-place writes
+    char *dir = g_path_get_dirname(path);
+    watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch_fd < 0) {
+        log_warn("⚠️  inotify_init1: %s\n", strerror(errno));
+        g_free(dir);
+        return FALSE;
+    }
+    if (inotify_add_watch(watch_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM) < 0) {
+        log_debug("👀 Not watching %s: %s\n", dir, strerror(errno));
+        close(watch_fd);
+        watch_fd = -1;
+        g_free(dir);
+        return FALSE; // SIGHUP still reloads
+    }
+    g_free(dir);
+    
+    watch_source = g_unix_fd_source_new(watch_fd, G_IO_IN);
+    g_source_set_callback(watch_source, G_SOURCE_FUNC(config_file_changed), NULL, NULL);
+    g_source_attach(watch_source, NULL);
+    log_info("👀 Watching config %s\n", path);
+    return TRUE;
+}
+
+void config_unwatch(void) {
+    if (watch_source != NULL) {
+        g_source_destroy(watch_source);
+        g_source_unref(watch_source);
+        watch_source = NULL;
+    }
+    if (watch_fd >= 0) {
+        close(watch_fd);
+        watch_fd = -1;
+    }
+    g_clear_pointer(&watch_path, g_free);
+    g_clear_pointer(&watch_name, g_free);
+    g_clear_pointer(&watch_type, g_free);
+}
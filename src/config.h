@@ -0,0 +1,67 @@
+/*
+ * Config file with hot reload.
+ *
+ * Settings are read from a key file: the [default] group first, then the
+ * group named after the indicator type. The file's directory is watched
+ * with inotify on the GTK main context, so edits (including editors that
+ * replace the file) are re-read and handed to a callback, which diffs them
+ * against what is on screen and applies only the difference - no restart,
+ * no new window, no new layer surface.
+ *
+ *   [default]
+ *   thickness=4
+ *
+ *   [volume]
+ *   color=FF5733
+ *   position=auto              # or X,Y
+ *   orientation=horizontal
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <glib.h>
+
+typedef enum {
+    CONFIG_COLOR = 1 << 0,
+    CONFIG_POSITION = 1 << 1,
+    CONFIG_ORIENTATION = 1 << 2,
+    CONFIG_THICKNESS = 1 << 3,
+} ConfigField;
+
+typedef struct {
+    guint set;              // ConfigField bits that carry a value
+    double r, g, b;         // Line color (0.0 - 1.0)
+    int x, y;               // Position, x = -1 for auto (right edge)
+    gboolean vertical;      // Orientation
+    int thickness;          // Line thickness in pixels
+} ConfigSettings;
+
+typedef void (*ConfigChangedFunc)(const ConfigSettings *file, gpointer user_data);
+
+// $XDG_CONFIG_HOME/linestatus/TYPE.conf if it exists, else the shared
+// $XDG_CONFIG_HOME/linestatus/linestatus.conf (which may not exist yet)
+char *config_default_path(const char *type);
+
+// Read the settings for type from path. A missing file is an empty config;
+// FALSE (with a warning) means the file could not be parsed.
+gboolean config_load(const char *path, const char *type, ConfigSettings *settings);
+
+// Hex color "RRGGBB" or "#RRGGBB"
+gboolean config_parse_color(const char *str, double *r, double *g, double *b);
+
+// Values from file replace those in base, except for the fields in locked
+void config_merge(ConfigSettings *base, const ConfigSettings *file, guint locked);
+
+// ConfigField bits whose values differ
+guint config_diff(const ConfigSettings *a, const ConfigSettings *b);
+
+// Watch path and call func with the new file settings after every change
+gboolean config_watch(const char *path, const char *type, ConfigChangedFunc func, gpointer user_data);
+
+// Re-read the watched file now (SIGHUP)
+void config_reload(void);
+
+void config_unwatch(void);
+
+#endif /* CONFIG_H */
@@ -0,0 +1,27 @@
+#include "css.h"
+
+#include "log.h"
+
+static void on_parsing_error(GtkCssProvider *provider, GtkCssSection *section, GError *error, gpointer data) {
+    (void)provider; (void)section; (void)data;
+    log_warn("⚠️  CSS error: %s\n", error->message);
+}
+
+GtkCssProvider *css_install(const char *override_path) {
+    GtkCssProvider *provider = gtk_css_provider_new();
+    g_signal_connect(provider, "parsing-error", G_CALLBACK(on_parsing_error), NULL);
+    
+    if (override_path != NULL) {
+        gtk_css_provider_load_from_path(provider, override_path);
+        log_info("🎨 CSS loaded from: %s\n", override_path);
+    } else {
+        gtk_css_provider_load_from_resource(provider, CSS_RESOURCE_PATH);
+    }
+    
+    gtk_style_context_add_provider_for_display(
+        gdk_display_get_default(),
+        GTK_STYLE_PROVIDER(provider),
+        GTK_STYLE_PROVIDER_PRIORITY_APPLICATION
+    );
+    return provider;
+}
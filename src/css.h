@@ -0,0 +1,20 @@
+/*
+ * Stylesheet loading.
+ *
+ * src/style.css is compiled into the binary as a GResource
+ * (resource:///com/linestatus/style.css), so startup does not touch the
+ * filesystem unless an override path is given with --css.
+ */
+
+#ifndef CSS_H
+#define CSS_H
+
+#include <gtk/gtk.h>
+
+#define CSS_RESOURCE_PATH "/com/linestatus/style.css"
+
+// Load the override (if not NULL) or the embedded stylesheet and apply it
+// to the default display. The caller owns the returned provider.
+GtkCssProvider *css_install(const char *override_path);
+
+#endif /* CSS_H */
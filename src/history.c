@@ -0,0 +1,235 @@
+#include "history.h"
+
+#include <string.h>
+
+// Sequence numbers of window candidates in monotonic order (sliding min/max)
+typedef struct {
+    guint64 *seq;
+    float *value;
+    guint head;
+    guint len;
+    guint capacity;
+} MonoQueue;
+
+struct History {
+    float *samples;             // Ring, samples[(next - 1) % capacity] is the newest
+    guint capacity;
+    guint64 next;               // Sequence number of the next sample
+    MonoQueue max_queue;        // Decreasing values
+    MonoQueue min_queue;        // Increasing values
+    float peak;
+    guint peak_age;
+    
+    // Cached rendering: one column (row when vertical) per sample
+    cairo_surface_t *image;
+    gboolean vertical;
+    int thickness;              // Image size across the bar
+    guint64 rendered;           // Samples already in the image
+};
+
+static void queue_init(MonoQueue *queue, guint capacity) {
+    queue->seq = g_new(guint64, capacity);
+    queue->value = g_new(float, capacity);
+    queue->head = 0;
+    queue->len = 0;
+    queue->capacity = capacity;
+}
+
+static void queue_clear(MonoQueue *queue) {
+    g_free(queue->seq);
+    g_free(queue->value);
+}
+
+#define QUEUE_AT(queue, i) (((queue)->head + (i)) % (queue)->capacity)
+
+// Add seq/value, first dropping candidates it dominates and those that left the window
+static void queue_push(MonoQueue *queue, guint64 seq, float value, guint64 oldest, gboolean is_max) {
+    while (queue->len > 0) {
+        float back = queue->value[QUEUE_AT(queue, queue->len - 1)];
+        if (is_max ? back > value : back < value) {
+            break;
+        }
+        queue->len--;
+    }
+    while (queue->len > 0 && queue->seq[queue->head] < oldest) {
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->len--;
+    }
+    queue->seq[QUEUE_AT(queue, queue->len)] = seq;
+    queue->value[QUEUE_AT(queue, queue->len)] = value;
+    queue->len++;
+}
+
+static float queue_front(const MonoQueue *queue) {
+    return queue->len > 0 ? queue->value[queue->head] : 0.0f;
+}
+
+History *history_new(guint capacity) {
+    History *history = g_new0(History, 1);
+    history->capacity = CLAMP(capacity, 2, HISTORY_MAX_SAMPLES);
+    history->samples = g_new0(float, history->capacity);
+    queue_init(&history->max_queue, history->capacity);
+    queue_init(&history->min_queue, history->capacity);
+    return history;
+}
+
+void history_free(History *history) {
+    if (history == NULL) {
+        return;
+    }
+    if (history->image != NULL) {
+        cairo_surface_destroy(history->image);
+    }
+    queue_clear(&history->max_queue);
+    queue_clear(&history->min_queue);
+    g_free(history->samples);
+    g_free(history);
+}
+
+void history_push(History *history, float value) {
+    guint64 seq = history->next++;
+    guint64 oldest = history->next > history->capacity ? history->next - history->capacity : 0;
+    
+    history->samples[seq % history->capacity] = value;
+    queue_push(&history->max_queue, seq, value, oldest, TRUE);
+    queue_push(&history->min_queue, seq, value, oldest, FALSE);
+    
+    if (value >= history->peak) {
+        history->peak = value;
+        history->peak_age = 0;
+    } else if (++history->peak_age > HISTORY_PEAK_HOLD) {
+        history->peak = MAX(value, history->peak - HISTORY_PEAK_DECAY);
+    }
+}
+
+float history_min(const History *history) {
+    return queue_front(&history->min_queue);
+}
+
+float history_max(const History *history) {
+    return queue_front(&history->max_queue);
+}
+
+float history_peak(const History *history) {
+    return history->peak;
+}
+
+// Move the image content one sample per shift towards the old end
+static void image_scroll(History *history, guint shift) {
+    unsigned char *data = cairo_image_surface_get_data(history->image);
+    int stride = cairo_image_surface_get_stride(history->image);
+    int rows = cairo_image_surface_get_height(history->image);
+    
+    if (history->vertical) {
+        // Newest row on top: everything moves down
+        memmove(data + shift * stride, data, (rows - shift) * stride);
+    } else {
+        // Newest column on the right: every row moves left
+        for (int y = 0; y < rows; y++) {
+            unsigned char *row = data + y * stride;
+            memmove(row, row + shift * 4, (history->capacity - shift) * 4);
+        }
+    }
+}
+
+// Clear a slot (0 = oldest) and draw value into it
+static void image_draw_sample(History *history, cairo_t *cr, guint slot, float value) {
+    double amplitude = value * history->thickness;
+    
+    if (history->vertical) {
+        // Row capacity - 1 - slot, amplitude grows leftwards from the right edge
+        double y = history->capacity - 1 - slot;
+        cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+        cairo_rectangle(cr, 0, y, history->thickness, 1);
+        cairo_fill(cr);
+        cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+        cairo_rectangle(cr, history->thickness - amplitude, y, amplitude, 1);
+    } else {
+        // Column slot, amplitude grows upwards from the bottom
+        cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+        cairo_rectangle(cr, slot, 0, 1, history->thickness);
+        cairo_fill(cr);
+        cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+        cairo_rectangle(cr, slot, history->thickness - amplitude, 1, amplitude);
+    }
+    cairo_fill(cr);
+}
+
+// Bring the cached image up to date with the ring
+static void image_update(History *history, int thickness, gboolean vertical, double r, double g, double b) {
+    guint64 pending = history->next - history->rendered;
+    
+    // New geometry (or first use): start over and render the whole ring once
+    if (history->image == NULL || history->thickness != thickness || history->vertical != vertical) {
+        if (history->image != NULL) {
+            cairo_surface_destroy(history->image);
+        }
+        history->image = vertical ? cairo_image_surface_create(CAIRO_FORMAT_ARGB32, thickness, history->capacity)
+                                  : cairo_image_surface_create(CAIRO_FORMAT_ARGB32, history->capacity, thickness);
+        history->thickness = thickness;
+        history->vertical = vertical;
+        pending = history->capacity;
+    }
+    if (pending == 0) {
+        return;
+    }
+    pending = MIN(pending, history->capacity);
+    
+    cairo_surface_flush(history->image);
+    if (pending < history->capacity) {
+        image_scroll(history, pending);
+    }
+    cairo_surface_mark_dirty(history->image);
+    
+    // Only the new samples, in the slots at the newest end
+    cairo_t *cr = cairo_create(history->image);
+    cairo_set_source_rgb(cr, r, g, b);
+    for (guint64 i = 0; i < pending; i++) {
+        guint slot = history->capacity - pending + i;
+        float value = 0.0f; // Slots before the first sample stay empty
+        if (history->next + slot >= history->capacity) {
+            value = history->samples[(history->next + slot - history->capacity) % history->capacity];
+        }
+        image_draw_sample(history, cr, slot, value);
+    }
+    cairo_destroy(cr);
+    history->rendered = history->next;
+}
+
+// A marker line along the bar at level (0.0 - 1.0 across it)
+static void draw_marker(cairo_t *cr, int width, int height, gboolean vertical, float level) {
+    if (vertical) {
+        double x = width - level * width;
+        cairo_rectangle(cr, CLAMP(x, 0, width - 1), 0, 1, height);
+    } else {
+        double y = height - level * height;
+        cairo_rectangle(cr, 0, CLAMP(y, 0, height - 1), width, 1);
+    }
+    cairo_fill(cr);
+}
+
+void history_render(History *history, cairo_t *cr, int width, int height, gboolean vertical,
+                    double r, double g, double b) {
+    image_update(history, MAX(vertical ? width : height, 1), vertical, r, g, b);
+    
+    // The cached image stretched along the bar, one block per sample
+    cairo_save(cr);
+    if (vertical) {
+        cairo_scale(cr, 1.0, (double)height / history->capacity);
+    } else {
+        cairo_scale(cr, (double)width / history->capacity, 1.0);
+    }
+    cairo_set_source_surface(cr, history->image, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_NEAREST);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_restore(cr);
+    
+    // Min/max of the window in a dimmed color, peak-hold in full color
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    cairo_set_source_rgba(cr, r, g, b, 0.5);
+    draw_marker(cr, width, height, vertical, history_min(history));
+    draw_marker(cr, width, height, vertical, history_max(history));
+    cairo_set_source_rgb(cr, r, g, b);
+    draw_marker(cr, width, height, vertical, history_peak(history));
+}
@@ -0,0 +1,47 @@
+/*
+ * Value history (sparkline).
+ *
+ * The last N samples live in a fixed-size ring. They are rendered into a
+ * cached image with one column per sample; a new sample scrolls that image
+ * by one column and draws only the new column, so the per-frame cost does
+ * not grow with the history length. The image is then scaled onto the bar.
+ *
+ * Minimum and maximum over the window are kept with monotonic queues and
+ * the peak-hold level is updated per sample, so none of the markers needs
+ * a pass over the history either.
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <cairo.h>
+#include <glib.h>
+
+#define HISTORY_DEFAULT_SAMPLES 120
+#define HISTORY_MAX_SAMPLES 4096
+#define HISTORY_PEAK_HOLD 30        // Samples the peak stays before it falls
+#define HISTORY_PEAK_DECAY 0.02f    // Fall per sample after that
+
+typedef struct History History;
+
+History *history_new(guint capacity);
+
+void history_free(History *history);
+
+// Append a sample (0.0 - 1.0); the oldest falls out once the ring is full
+void history_push(History *history, float value);
+
+// Minimum and maximum of the samples in the ring, 0 while empty
+float history_min(const History *history);
+float history_max(const History *history);
+
+// Peak-hold level
+float history_peak(const History *history);
+
+// Paint the history over width x height: newest sample at the top (vertical)
+// or on the right (horizontal), amplitude growing away from the screen edge
+// the bar sits on. Only samples pushed since the last call are rendered.
+void history_render(History *history, cairo_t *cr, int width, int height, gboolean vertical,
+                    double r, double g, double b);
+
+#endif /* HISTORY_H */
@@ -0,0 +1,721 @@
+#define _GNU_SOURCE
+#include "ingest.h"
+
+#include <glib-unix.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+
+#include "bus.h"
+#include "ingest_uring.h"
+#include "linebuf.h"
+#include "log.h"
+#include "ratelimit.h"
+#include "source.h"
+#include "stats.h"
+#include "trace.h"
+#include "values.h"
+
+#define INGEST_RING_MASK (INGEST_RING_SIZE - 1)
+#define INGEST_RETRY_MS 2   // Ring full: how soon to retry handing over
+#define INGEST_CLIENT_SLICE LINEBUF_SIZE    // Bytes read per connection and wakeup, so ready ones take turns
+#define INGEST_ACCEPT_BATCH 32              // Connections accepted per wakeup before serving the others
+
+// One socket connection, for either backend
+typedef struct {
+    int fd;
+    gint64 accepted;        // Monotonic time the connection was accepted, 0 if not traced
+    Producer *producer;     // Rate limit bucket of the peer, NULL if unlimited
+    gboolean backpressure;  // Client sent "backpressure": tell it when it is over its rate
+    gboolean throttled;     // Told so, and nothing admitted since
+} IngestConnection;
+
+// One connected socket client of the GLib backend
+typedef struct {
+    IngestConnection conn;
+    GSource *watch;
+    LineBuffer lines;
+} IngestClient;
+
+// Ingest side (thread-only state)
+static IngestConfig config;
+static GMainContext *ingest_context = NULL;
+static GMainLoop *ingest_loop = NULL;
+static GThread *ingest_thread = NULL;
+static GSource *listen_watch = NULL;
+static GSource *stdin_watch = NULL;
+static GSource *flush_source = NULL;
+static gboolean uring_active = FALSE;       // Socket served by the io_uring backend
+static LineBuffer stdin_lines;
+static int stdin_flags = -1;                // File status flags stdin had before we made it non-blocking
+static GPtrArray *clients = NULL;           // IngestClient *
+static UpdateBatch pending;                 // Parsed, not yet handed to the GTK thread
+static gboolean flush_retry = FALSE;        // Ring was full, waiting for the retry time
+static GArray *published = NULL;            // Update, ingest_publish() before the start
+
+// Single-producer/single-consumer ring shared with the GTK thread
+static Update ring[INGEST_RING_SIZE];
+static atomic_uint ring_head;               // Written by the ingest side only
+static atomic_uint ring_tail;               // Written by the GTK side only
+static atomic_int ui_wakeup_pending;        // Set once a wakeup is in flight
+
+// GTK side
+static GSource *ui_source = NULL;
+
+// Ring ----------------------------------------------------------------------
+
+// Push as many of count updates as fit without cutting a vector, published
+// with one store so the GTK side sees all of them or none; returns how many
+static int ring_push_many(const Update *updates, int count) {
+    unsigned int head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+    int n = MIN(count, (int)(INGEST_RING_SIZE - (head - tail)));
+    
+    // Segments of a vector are queued next to each other: back off to its start
+    while (n > 0 && n < count && updates[n].index > 0 && strcmp(updates[n].key, updates[n - 1].key) == 0) {
+        n--;
+    }
+    
+    for (int i = 0; i < n; i++) {
+        ring[(head + i) & INGEST_RING_MASK] = updates[i];
+    }
+    if (n > 0) {
+        atomic_store_explicit(&ring_head, head + n, memory_order_release);
+    }
+    return n;
+}
+
+static gboolean ring_pop(Update *update) {
+    unsigned int tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&ring_head, memory_order_acquire);
+    
+    if (tail == head) {
+        return FALSE; // Empty
+    }
+    
+    *update = ring[tail & INGEST_RING_MASK];
+    atomic_store_explicit(&ring_tail, tail + 1, memory_order_release);
+    return TRUE;
+}
+
+static gboolean ring_is_empty(void) {
+    return atomic_load_explicit(&ring_tail, memory_order_relaxed) ==
+           atomic_load_explicit(&ring_head, memory_order_acquire);
+}
+
+// GTK side: drain the ring ---------------------------------------------------
+
+// A vector must reach config.apply in one pass: count runs of segments whose
+// segment 0 is not in the same batch
+static void check_vectors(const UpdateBatch *batch) {
+    for (int i = 0; i < batch->count; i++) {
+        const Update *update = &batch->items[i];
+        gboolean whole = FALSE;
+        
+        if (update->index == 0 || (i > 0 && strcmp(batch->items[i - 1].key, update->key) == 0)) {
+            continue;
+        }
+        for (int j = 0; j < batch->count && !whole; j++) {
+            whole = batch->items[j].index == 0 && strcmp(batch->items[j].key, update->key) == 0;
+        }
+        if (!whole) {
+            stats_inc(&stats.vectors_split);
+            log_debug("⚠️  Vector %s applied without its first segments\n", update->key);
+        }
+    }
+}
+
+static gboolean ui_source_prepare(GSource *source, gint *timeout) {
+    (void)source;
+    *timeout = -1;
+    return !ring_is_empty();
+}
+
+static gboolean ui_source_check(GSource *source) {
+    (void)source;
+    return !ring_is_empty();
+}
+
+static gboolean ui_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data) {
+    (void)source; (void)callback; (void)user_data;
+    UpdateBatch batch;
+    Update update;
+    
+    // Clear before draining so anything pushed from now on wakes us again
+    atomic_store(&ui_wakeup_pending, 0);
+    
+    // Collapse everything queued since the last frame to one value per key
+    update_batch_clear(&batch);
+    while (ring_pop(&update)) {
+        Update replaced;
+        int result = update_batch_put(&batch, &update, &replaced);
+        if (result < 0) {
+            config.apply(&update, config.user_data);
+        } else if (result > 0) {
+            stats_inc(&stats.coalesced);
+            trace_event(TRACE_COALESCED, replaced.trace_id, replaced.key);
+        }
+    }
+    
+    check_vectors(&batch);
+    for (int i = 0; i < batch.count; i++) {
+        config.apply(&batch.items[i], config.user_data);
+    }
+    
+    // All segments of a vector are in by now: one redraw for the whole pass
+    if (batch.count > 0 && config.applied != NULL) {
+        config.applied(config.user_data);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs ui_source_funcs = {
+    ui_source_prepare,
+    ui_source_check,
+    ui_source_dispatch,
+    NULL, NULL, NULL
+};
+
+// Ingest side: hand pending values to the GTK thread -------------------------
+
+static gboolean flush_source_prepare(GSource *source, gint *timeout) {
+    (void)source;
+    *timeout = -1;
+    return pending.count > 0 && !flush_retry;
+}
+
+static gboolean flush_source_check(GSource *source) {
+    (void)source;
+    return pending.count > 0 && !flush_retry;
+}
+
+// Runs after every input handler of a main loop iteration, so one batch of
+// reads turns into one hand-over and at most one GTK wakeup
+static gboolean flush_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data) {
+    (void)callback; (void)user_data;
+    int pushed;
+    
+    flush_retry = FALSE;
+    pushed = ring_push_many(pending.items, pending.count);
+    
+    if (pushed < pending.count) {
+        // GTK thread is behind - keep the rest (still latest per key) and retry
+        memmove(pending.items, pending.items + pushed, (pending.count - pushed) * sizeof(Update));
+        pending.count -= pushed;
+        flush_retry = TRUE;
+        g_source_set_ready_time(source, g_get_monotonic_time() + INGEST_RETRY_MS * 1000);
+    } else {
+        pending.count = 0;
+        g_source_set_ready_time(source, -1);
+    }
+    
+    if (pushed > 0 && !atomic_exchange(&ui_wakeup_pending, 1)) {
+        g_main_context_wakeup(NULL);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs flush_source_funcs = {
+    flush_source_prepare,
+    flush_source_check,
+    flush_source_dispatch,
+    NULL, NULL, NULL
+};
+
+// Queue one admitted value for the GTK thread, latest per key wins
+// (receipt is counted earlier, in ingest_receive())
+static void ingest_put(const Update *update) {
+    Update replaced;
+    stats_inc(&stats.updates_admitted);
+    values_store(update);
+    
+    int result = update_batch_put(&pending, update, &replaced);
+    if (result > 0) {
+        stats_inc(&stats.coalesced);
+        trace_event(TRACE_COALESCED, replaced.trace_id, replaced.key);
+    } else if (result < 0) {
+        stats_inc(&stats.dropped);
+        trace_event(TRACE_COALESCED, update->trace_id, update->key);
+        log_warn("⚠️  Too many distinct keys in one batch, dropping %s\n", update->key);
+    }
+}
+
+// Input handlers ------------------------------------------------------------
+
+// Every update counts as received once, when it arrives - even if it is
+// held by the rate limiter and replaced before it is admitted
+static void ingest_receive(const Update *update) {
+    stats_count_key(update->key);
+}
+
+static GSource *ingest_attach(GSource *source, GSourceFunc func, gpointer data) {
+    g_source_set_callback(source, func, data, NULL);
+    g_source_attach(source, ingest_context);
+    return source;
+}
+
+// Best effort reply on a socket connection
+static void client_reply(int fd, const char *text) {
+    size_t len = strlen(text);
+    while (len > 0) {
+        ssize_t written = send(fd, text, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            break; // Client is not reading - it loses the rest
+        }
+        text += written;
+        len -= written;
+    }
+}
+
+// Once per episode, tell a client that asked for it how long to back off
+static void connection_throttled(IngestConnection *conn, gboolean held) {
+    if (!held) {
+        conn->throttled = FALSE;
+        return;
+    }
+    if (!conn->backpressure || conn->throttled) {
+        return;
+    }
+    
+    char reply[32];
+    snprintf(reply, sizeof(reply), "slow %" G_GINT64_FORMAT "\n", (ratelimit_wait_us(conn->producer) + 999) / 1000);
+    client_reply(conn->fd, reply);
+    stats_inc(&stats.backpressure_replies);
+    conn->throttled = TRUE;
+}
+
+// conn: the socket connection the line came from, NULL for other inputs
+static void ingest_parse(char *line, const char *origin, IngestConnection *conn) {
+    UpdateBatch parsed;
+    int errors = 0;
+    
+    update_batch_clear(&parsed);
+    protocol_parse_line(line, config.default_key, g_get_monotonic_time(), &parsed, &errors);
+    for (int i = 0; i < parsed.count; i++) {
+        Update *update = &parsed.items[i];
+        
+        update->trace_id = trace_next_id();
+        if (update->trace_id != 0) {
+            trace_event_sent(update->trace_id, update->key, update->sent);
+            if (conn != NULL && conn->accepted != 0) {
+                trace_event_at(TRACE_ACCEPT, update->trace_id, update->key, conn->accepted);
+            }
+            trace_event(TRACE_PARSE, update->trace_id, update->key);
+        }
+        ingest_receive(update);
+    }
+    
+    // One token for the whole line: over the producer's rate, all of it is
+    // held and handed on later by ratelimit, so a vector is never split
+    if (conn != NULL && parsed.count > 0) {
+        gboolean admitted = ratelimit_admit(conn->producer, &parsed);
+        connection_throttled(conn, !admitted);
+        if (!admitted) {
+            parsed.count = 0;
+        }
+    }
+    for (int i = 0; i < parsed.count; i++) {
+        ingest_put(&parsed.items[i]);
+    }
+    
+    if (errors > 0) {
+        atomic_fetch_add_explicit(&stats.parse_errors, errors, memory_order_relaxed);
+        log_count_invalid();
+        log_debug("⚠️  Invalid value from %s (%d bad token%s)\n", origin, errors, errors == 1 ? "" : "s");
+    }
+}
+
+// A line from a socket client: either a command or update values
+static void socket_line(char *line, IngestConnection *conn) {
+    int fd = conn->fd;
+    
+    if (strcmp(line, "stats") == 0) {
+        char *reply = stats_format();
+        client_reply(fd, reply);
+        g_free(reply);
+        return;
+    }
+    
+    if (strcmp(line, "trace") == 0) {
+        char *path = trace_dump();
+        char *reply = path ? g_strdup_printf("%s\n", path)
+                           : g_strdup("error: tracing is off (start with --trace)\n");
+        client_reply(fd, reply);
+        g_free(reply);
+        g_free(path);
+        return;
+    }
+    
+    if (strncmp(line, "get ", 4) == 0) {
+        char *reply = values_command_get(g_strstrip(line + 4));
+        client_reply(fd, reply);
+        g_free(reply);
+        return;
+    }
+    
+    if (strcmp(line, "subscribe") == 0 || strncmp(line, "subscribe ", 10) == 0) {
+        const char *error = values_command_subscribe(fd, g_strstrip(line + 9));
+        if (error != NULL) {
+            client_reply(fd, error);
+        }
+        return;
+    }
+    
+    if (strcmp(line, "backpressure") == 0) {
+        conn->backpressure = TRUE;
+        return;
+    }
+    
+    ingest_parse(line, "socket", conn);
+}
+
+static void connection_init(IngestConnection *conn, int fd) {
+    conn->fd = fd;
+    conn->accepted = trace_enabled ? g_get_monotonic_time() : 0;
+    conn->producer = ratelimit_attach(fd);
+}
+
+// io_uring backend: connection state lives with its client there
+static gpointer uring_open(int fd) {
+    IngestConnection *conn = g_new0(IngestConnection, 1);
+    connection_init(conn, fd);
+    return conn;
+}
+
+static void uring_line(char *line, gpointer connection) {
+    socket_line(line, connection);
+}
+
+static void uring_close(gpointer connection) {
+    IngestConnection *conn = connection;
+    ratelimit_detach(conn->producer);
+    g_free(conn);
+}
+
+static void client_line(char *line, void *user_data) {
+    IngestClient *client = user_data;
+    socket_line(line, &client->conn);
+}
+
+static void stdin_line(char *line, void *user_data) {
+    (void)user_data;
+    ingest_parse(line, "stdin", NULL);
+}
+
+static void client_free(IngestClient *client) {
+    if (client->watch) {
+        g_source_destroy(client->watch);
+        g_source_unref(client->watch);
+    }
+    ratelimit_detach(client->conn.producer);
+    close(client->conn.fd);
+    g_free(client);
+}
+
+static gboolean handle_client(gint fd, GIOCondition condition, gpointer user_data) {
+    IngestClient *client = user_data;
+    (void)condition;
+    
+    // One slice per wakeup: every ready connection gets its turn in the same iteration
+    ssize_t result = linebuf_read_fd_budget(&client->lines, fd, INGEST_CLIENT_SLICE, client_line, client);
+    if (result > 0 || (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))) {
+        return G_SOURCE_CONTINUE; // Persistent client, wait for more
+    }
+    
+    // EOF or error - one-shot senders (send-status + socat) end up here
+    g_ptr_array_remove_fast(clients, client);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean handle_listen(gint fd, GIOCondition condition, gpointer user_data) {
+    (void)condition; (void)user_data;
+    
+    // Accept a batch of pending connections per wakeup; the rest wait one
+    // iteration so a connection storm cannot starve established clients
+    for (int accepted = 0; accepted < INGEST_ACCEPT_BATCH; accepted++) {
+        int client_fd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break; // EAGAIN: backlog drained
+        }
+        
+        if (clients->len >= INGEST_MAX_CLIENTS) {
+            stats_inc(&stats.connections_refused);
+            log_warn("⚠️  Too many socket clients, refusing connection\n");
+            close(client_fd);
+            continue;
+        }
+        stats_inc(&stats.connections_accepted);
+        
+        IngestClient *client = g_new0(IngestClient, 1);
+        connection_init(&client->conn, client_fd);
+        linebuf_init(&client->lines);
+        client->watch = ingest_attach(g_unix_fd_source_new(client_fd, G_IO_IN | G_IO_HUP | G_IO_ERR),
+                                      G_SOURCE_FUNC(handle_client), client);
+        g_ptr_array_add(clients, client);
+        
+        // Most senders have already written and closed - read right away
+        handle_client(client_fd, G_IO_IN, client);
+    }
+    
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean handle_stdin(gint fd, GIOCondition condition, gpointer user_data) {
+    (void)condition; (void)user_data;
+    
+    ssize_t result = linebuf_read_fd(&stdin_lines, fd, stdin_line, NULL);
+    if (result > 0 || (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))) {
+        return G_SOURCE_CONTINUE;
+    }
+    
+    log_info("📭 stdin closed, no more updates from it\n");
+    g_source_unref(stdin_watch);
+    stdin_watch = NULL;
+    return G_SOURCE_REMOVE;
+}
+
+static void on_source_value(const char *key, float value, gpointer user_data) {
+    (void)user_data;
+    Update update = { .value = value, .received = g_get_monotonic_time() };
+    
+    g_strlcpy(update.key, key, sizeof(update.key));
+    update.trace_id = trace_next_id();
+    trace_event(TRACE_PARSE, update.trace_id, update.key);
+    ingest_receive(&update);
+    ingest_put(&update);
+}
+
+// SetValue / SetValues / Adjust from the session bus
+static void on_bus_value(const Update *update) {
+    Update traced = *update;
+    
+    traced.trace_id = trace_next_id();
+    trace_event(TRACE_PARSE, traced.trace_id, traced.key);
+    ingest_receive(&traced);
+    ingest_put(&traced);
+}
+
+// Lifecycle -----------------------------------------------------------------
+
+// Install every input on the current thread-default context
+static void ingest_setup(void) {
+    clients = g_ptr_array_new_with_free_func((GDestroyNotify)client_free);
+    update_batch_clear(&pending);
+    
+    flush_source = g_source_new(&flush_source_funcs, sizeof(GSource));
+    g_source_set_name(flush_source, "linestatus-ingest-flush");
+    g_source_attach(flush_source, ingest_context);
+    
+    // Socket producers over their rate are held and handed on here later
+    ratelimit_init(ingest_context, config.client_rate, config.client_burst, ingest_put);
+    
+    // Values published before the start (restored state, command line)
+    values_init(ingest_context);
+    if (published != NULL) {
+        for (guint i = 0; i < published->len; i++) {
+            values_store(&g_array_index(published, Update, i));
+        }
+        g_array_free(published, TRUE);
+        published = NULL;
+    }
+    
+    // Registered here so GDBus dispatches the calls on this context
+    if (config.bus != NULL) {
+        bus_export(config.bus, config.bus_path, config.default_key, on_bus_value);
+    }
+    
+    if (config.listen_fd >= 0) {
+        g_unix_set_fd_nonblocking(config.listen_fd, TRUE, NULL);
+        
+        // io_uring if requested and usable, otherwise the GLib accept loop
+        uring_active = config.io_uring &&
+                       ingest_uring_start(config.listen_fd, ingest_context, uring_open, uring_line, uring_close);
+        if (!uring_active) {
+            listen_watch = ingest_attach(g_unix_fd_source_new(config.listen_fd, G_IO_IN),
+                                         G_SOURCE_FUNC(handle_listen), NULL);
+        }
+    }
+    
+    if (config.watch_stdin) {
+        // The open file description is shared with whoever started us (an
+        // interactive shell's tty, say): remember its flags to put them back
+        linebuf_init(&stdin_lines);
+        stdin_flags = fcntl(STDIN_FILENO, F_GETFL);
+        g_unix_set_fd_nonblocking(STDIN_FILENO, TRUE, NULL);
+        stdin_watch = ingest_attach(g_unix_fd_source_new(STDIN_FILENO, G_IO_IN | G_IO_HUP | G_IO_ERR),
+                                    G_SOURCE_FUNC(handle_stdin), NULL);
+    }
+    
+    for (guint i = 0; config.sources != NULL && i < config.sources->len; i++) {
+        StatusSource *src = g_ptr_array_index(config.sources, i);
+        if (!source_start(src, on_source_value, NULL)) {
+            log_warn("⚠️  Source for %s could not be started\n", src->key);
+        }
+    }
+}
+
+static void ingest_teardown(void) {
+    // Sources first: they may still be attached to the context
+    if (config.sources) {
+        g_ptr_array_free(config.sources, TRUE);
+        config.sources = NULL;
+    }
+    
+    if (clients) {
+        g_ptr_array_free(clients, TRUE);
+        clients = NULL;
+    }
+    
+    if (uring_active) {
+        ingest_uring_stop();
+        uring_active = FALSE;
+    }
+    
+    ratelimit_shutdown();
+    bus_unexport();
+    values_shutdown();
+    
+    GSource **watches[] = { &listen_watch, &stdin_watch, &flush_source };
+    for (gsize i = 0; i < G_N_ELEMENTS(watches); i++) {
+        if (*watches[i]) {
+            g_source_destroy(*watches[i]);
+            g_source_unref(*watches[i]);
+            *watches[i] = NULL;
+        }
+    }
+    
+    if (stdin_flags >= 0) {
+        fcntl(STDIN_FILENO, F_SETFL, stdin_flags);
+        stdin_flags = -1;
+    }
+}
+
+static gpointer ingest_thread_main(gpointer data) {
+    (void)data;
+    
+    g_main_context_push_thread_default(ingest_context);
+    ingest_setup();
+    g_main_loop_run(ingest_loop);
+    ingest_teardown();
+    g_main_context_pop_thread_default(ingest_context);
+    
+    return NULL;
+}
+
+gboolean ingest_start(const IngestConfig *cfg) {
+    // Only one pipeline: config, the ring and ui_source are process-wide
+    if (ingest_context != NULL) {
+        log_warn("⚠️  Ingest already running, not starting it again\n");
+        return FALSE;
+    }
+    config = *cfg;
+    
+    // The GTK side drains the ring from the default main context
+    ui_source = g_source_new(&ui_source_funcs, sizeof(GSource));
+    g_source_set_name(ui_source, "linestatus-ingest-apply");
+    g_source_set_priority(ui_source, G_PRIORITY_HIGH);
+    g_source_attach(ui_source, NULL);
+    
+    if (!config.threaded) {
+        // Same pipeline, driven by the GTK main loop
+        ingest_context = g_main_context_ref(g_main_context_default());
+        ingest_setup();
+        return TRUE;
+    }
+    
+    ingest_context = g_main_context_new();
+    ingest_loop = g_main_loop_new(ingest_context, FALSE);
+    ingest_thread = g_thread_new("linestatus-ingest", ingest_thread_main, NULL);
+    return ingest_thread != NULL;
+}
+
+static gboolean publish_on_ingest(gpointer data) {
+    values_store(data);
+    return G_SOURCE_REMOVE;
+}
+
+void ingest_publish(const Update *update) {
+    if (ingest_context == NULL) {
+        if (published == NULL) {
+            published = g_array_new(FALSE, FALSE, sizeof(Update));
+        }
+        g_array_append_val(published, *update);
+        return;
+    }
+    Update *copy = g_new(Update, 1);
+    *copy = *update;
+    g_main_context_invoke_full(ingest_context, G_PRIORITY_DEFAULT, publish_on_ingest, copy, g_free);
+}
+
+// An update from the GTK thread, queued behind everything received before it
+typedef struct {
+    Update update;
+    gboolean relative;      // value is a step from the latest value of the key
+} Submission;
+
+static gboolean submit_on_ingest(gpointer data) {
+    Submission *submission = data;
+    Update *update = &submission->update;
+    float current = 0.0f;
+    
+    if (submission->relative) {
+        values_lookup(update->key, update->index, &current);
+        update->value = fmaxf(0.0f, fminf(1.0f, current + update->value));
+    }
+    update->received = g_get_monotonic_time();
+    update->trace_id = trace_next_id();
+    trace_event(TRACE_PARSE, update->trace_id, update->key);
+    ingest_receive(update);
+    ingest_put(update);
+    return G_SOURCE_REMOVE;
+}
+
+void ingest_submit(const Update *update, gboolean relative) {
+    if (ingest_context == NULL) {
+        return; // Not started, nothing could apply it
+    }
+    Submission *submission = g_new(Submission, 1);
+    submission->update = *update;
+    submission->relative = relative;
+    g_main_context_invoke_full(ingest_context, G_PRIORITY_DEFAULT, submit_on_ingest, submission, g_free);
+}
+
+void ingest_stop(void) {
+    if (ingest_thread) {
+        g_main_loop_quit(ingest_loop);
+        g_thread_join(ingest_thread);
+        ingest_thread = NULL;
+        g_main_loop_unref(ingest_loop);
+        ingest_loop = NULL;
+    } else if (ingest_context) {
+        ingest_teardown();
+    }
+    
+    if (ingest_context) {
+        g_main_context_unref(ingest_context);
+        ingest_context = NULL;
+    }
+    
+    if (ui_source) {
+        g_source_destroy(ui_source);
+        g_source_unref(ui_source);
+        ui_source = NULL;
+    }
+    
+    if (published != NULL) {
+        g_array_free(published, TRUE); // Never started
+        published = NULL;
+    }
+}
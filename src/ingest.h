@@ -0,0 +1,62 @@
+/*
+ * Update ingestion - socket clients, stdin and native sources.
+ *
+ * All input I/O and parsing runs in a dedicated ingest thread with its own
+ * GMainContext, so a slow frame on the GTK side never delays accept/read
+ * and a flood of updates never steals time from rendering. Parsed values
+ * are coalesced (latest per key) and handed to the GTK thread through a
+ * lock-free single-producer/single-consumer ring; the GTK main loop is
+ * woken with a single g_main_context_wakeup() per batch.
+ *
+ * With threaded = FALSE the exact same code runs on the GTK main context.
+ */
+
+#ifndef INGEST_H
+#define INGEST_H
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "protocol.h"
+
+#define INGEST_RING_SIZE 1024       // Must be a power of two
+#define INGEST_MAX_CLIENTS 128      // Concurrent socket connections
+
+// Called on the GTK thread for every (coalesced) update
+typedef void (*IngestApplyFunc)(const Update *update, gpointer user_data);
+
+// Called on the GTK thread after each pass that applied updates
+typedef void (*IngestAppliedFunc)(gpointer user_data);
+
+typedef struct {
+    int listen_fd;              // Listening Unix socket, -1 for none (not owned)
+    gboolean watch_stdin;       // Stream updates from stdin
+    GPtrArray *sources;         // StatusSource * to drive, may be NULL (ownership passes to ingest)
+    const char *default_key;    // Key for plain "60" messages
+    gboolean threaded;          // Run I/O in the ingest thread
+    gboolean io_uring;          // Serve the socket through io_uring if available
+    double client_rate;         // Updates per second per socket producer, 0 for unlimited
+    double client_burst;        // Tokens a producer may save up
+    GDBusConnection *bus;       // Export com.linestatus.Indicator on it, NULL for none
+    const char *bus_path;       // Object path for the interface
+    IngestApplyFunc apply;
+    IngestAppliedFunc applied;  // May be NULL
+    gpointer user_data;
+} IngestConfig;
+
+// Start ingesting; returns FALSE if the thread could not be started
+gboolean ingest_start(const IngestConfig *config);
+
+// Make a value that did not arrive through ingest (restored, --set) readable
+// with "get" / "subscribe"; callable from the GTK thread before or after start
+void ingest_publish(const Update *update);
+
+// Feed an update from the GTK thread (command line) through ingest, ordered
+// after everything already received; with relative, value is a step added
+// to the latest value of the key. Ignored before ingest_start().
+void ingest_submit(const Update *update, gboolean relative);
+
+// Stop the ingest thread, close all client connections and free the sources
+void ingest_stop(void);
+
+#endif /* INGEST_H */
@@ -0,0 +1,293 @@
+#define _GNU_SOURCE
+#include "ingest_uring.h"
+
+#include <stdio.h>
+
+#include "log.h"
+
+#ifdef HAVE_IO_URING
+
+#include <glib-unix.h>
+#include <liburing.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/utsname.h>
+
+#include "ingest.h"
+#include "linebuf.h"
+#include "stats.h"
+
+#define URING_ENTRIES 256
+#define URING_CQ_ENTRIES 4096       // Room for a burst of multishot accept/recv completions
+#define URING_BUF_GROUP 0
+#define URING_BUF_COUNT 256         // Must be a power of two
+#define URING_BUF_SIZE 2048
+
+// user_data layout: operation in the high 32 bits, fd in the low 32
+#define URING_OP_ACCEPT 1ULL
+#define URING_OP_RECV   2ULL
+#define URING_DATA(op, fd) (((op) << 32) | (uint32_t)(fd))
+#define URING_DATA_OP(data) ((data) >> 32)
+#define URING_DATA_FD(data) ((int)((data) & 0xffffffffu))
+
+// One connected producer
+typedef struct {
+    int fd;
+    gpointer connection;    // From open_func
+    LineBuffer lines;
+} UringClient;
+
+static struct io_uring ring;
+static gboolean ring_ready = FALSE;
+static struct io_uring_buf_ring *buf_ring = NULL;
+static char *buffers = NULL;
+static GSource *ring_watch = NULL;
+static GHashTable *uring_clients = NULL;    // fd -> UringClient *
+static int uring_listen_fd = -1;
+static UringOpenFunc open_func = NULL;
+static UringLineFunc line_func = NULL;
+static UringCloseFunc close_func = NULL;
+
+// Multishot recv with provided buffer rings needs Linux 6.0
+static gboolean kernel_supports_multishot(void) {
+    struct utsname name;
+    int major = 0;
+    
+    if (uname(&name) != 0 || sscanf(name.release, "%d.", &major) != 1) {
+        return FALSE;
+    }
+    return major >= 6;
+}
+
+// A free submission slot; a full queue is submitted first to make room
+static struct io_uring_sqe *uring_get_sqe(void) {
+    struct io_uring_sqe *sqe = io_uring_get_sqe(&ring);
+    
+    if (sqe == NULL) {
+        io_uring_submit(&ring);
+        sqe = io_uring_get_sqe(&ring);
+    }
+    return sqe;
+}
+
+static void uring_arm_accept(void) {
+    struct io_uring_sqe *sqe = uring_get_sqe();
+    if (sqe == NULL) {
+        log_warn("⚠️  io_uring submission queue full, cannot accept connections\n");
+        return;
+    }
+    io_uring_prep_multishot_accept(sqe, uring_listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    io_uring_sqe_set_data64(sqe, URING_DATA(URING_OP_ACCEPT, uring_listen_fd));
+}
+
+// FALSE if no request could be queued; the caller drops the client
+static gboolean uring_arm_recv(int fd) {
+    struct io_uring_sqe *sqe = uring_get_sqe();
+    if (sqe == NULL) {
+        log_warn("⚠️  io_uring submission queue full, dropping client\n");
+        return FALSE;
+    }
+    io_uring_prep_recv_multishot(sqe, fd, NULL, 0, 0);
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUF_GROUP;
+    io_uring_sqe_set_data64(sqe, URING_DATA(URING_OP_RECV, fd));
+    return TRUE;
+}
+
+// Give a consumed buffer back to the kernel
+static void uring_recycle_buffer(unsigned short bid) {
+    io_uring_buf_ring_add(buf_ring, buffers + (size_t)bid * URING_BUF_SIZE, URING_BUF_SIZE, bid,
+                          io_uring_buf_ring_mask(URING_BUF_COUNT), 0);
+    io_uring_buf_ring_advance(buf_ring, 1);
+}
+
+static void uring_client_line(char *line, void *user_data) {
+    UringClient *client = user_data;
+    line_func(line, client->connection);
+}
+
+static void uring_client_free(gpointer data) {
+    UringClient *client = data;
+    close_func(client->connection);
+    close(client->fd);
+    g_free(client);
+}
+
+static void uring_handle_accept(struct io_uring_cqe *cqe) {
+    if (cqe->res >= 0) {
+        if (g_hash_table_size(uring_clients) >= INGEST_MAX_CLIENTS) {
+            stats_inc(&stats.connections_refused);
+            log_warn("⚠️  Too many socket clients, refusing connection\n");
+            close(cqe->res);
+        } else {
+            stats_inc(&stats.connections_accepted);
+            UringClient *client = g_new0(UringClient, 1);
+            client->fd = cqe->res;
+            client->connection = open_func(client->fd);
+            linebuf_init(&client->lines);
+            g_hash_table_insert(uring_clients, GINT_TO_POINTER(client->fd), client);
+            if (!uring_arm_recv(client->fd)) {
+                g_hash_table_remove(uring_clients, GINT_TO_POINTER(client->fd));
+            }
+        }
+    }
+    
+    // The kernel ends a multishot request on errors/overflow - re-arm it
+    if (!(cqe->flags & IORING_CQE_F_MORE)) {
+        uring_arm_accept();
+    }
+}
+
+static void uring_handle_recv(struct io_uring_cqe *cqe, int fd) {
+    UringClient *client = g_hash_table_lookup(uring_clients, GINT_TO_POINTER(fd));
+    
+    if (cqe->res > 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+        unsigned short bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        if (client) {
+            linebuf_feed(&client->lines, buffers + (size_t)bid * URING_BUF_SIZE, cqe->res,
+                         uring_client_line, client);
+        }
+        uring_recycle_buffer(bid);
+    }
+    
+    if (client == NULL || (cqe->flags & IORING_CQE_F_MORE)) {
+        return;
+    }
+    
+    if (cqe->res == -ENOBUFS) {
+        // All buffers were in use - try again
+        if (!uring_arm_recv(fd)) {
+            g_hash_table_remove(uring_clients, GINT_TO_POINTER(fd));
+        }
+    } else if (cqe->res <= 0) {
+        // EOF or error: an unterminated last line still counts
+        if (client->lines.len > 0 && !client->lines.overflow) {
+            linebuf_feed(&client->lines, "\n", 1, uring_client_line, client);
+        }
+        g_hash_table_remove(uring_clients, GINT_TO_POINTER(fd));
+    } else if (!uring_arm_recv(fd)) {
+        g_hash_table_remove(uring_clients, GINT_TO_POINTER(fd));
+    }
+}
+
+// The ring fd polls readable whenever completions are waiting
+static gboolean uring_ready_cb(gint fd, GIOCondition condition, gpointer user_data) {
+    (void)fd; (void)condition; (void)user_data;
+    struct io_uring_cqe *cqes[URING_ENTRIES];
+    unsigned count;
+    
+    while ((count = io_uring_peek_batch_cqe(&ring, cqes, URING_ENTRIES)) > 0) {
+        for (unsigned i = 0; i < count; i++) {
+            uint64_t data = io_uring_cqe_get_data64(cqes[i]);
+            if (URING_DATA_OP(data) == URING_OP_ACCEPT) {
+                uring_handle_accept(cqes[i]);
+            } else {
+                uring_handle_recv(cqes[i], URING_DATA_FD(data));
+            }
+        }
+        io_uring_cq_advance(&ring, count);
+        
+        // One submit per batch for everything re-armed while handling it
+        io_uring_submit(&ring);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+gboolean ingest_uring_start(int listen_fd, GMainContext *context,
+                            UringOpenFunc on_open, UringLineFunc on_line, UringCloseFunc on_close) {
+    struct io_uring_params params;
+    int ret;
+    
+    if (!kernel_supports_multishot()) {
+        log_warn("⚠️  io_uring backend needs Linux 6.0 or newer, using GLib backend\n");
+        return FALSE;
+    }
+    
+    // A larger completion queue so an accept burst does not overflow it
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER;
+    params.cq_entries = URING_CQ_ENTRIES;
+    ret = io_uring_queue_init_params(URING_ENTRIES, &ring, &params);
+    if (ret < 0) {
+        memset(&params, 0, sizeof(params));
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = URING_CQ_ENTRIES;
+        ret = io_uring_queue_init_params(URING_ENTRIES, &ring, &params);
+    }
+    if (ret < 0) {
+        log_warn("⚠️  io_uring unavailable (%s), using GLib backend\n", strerror(-ret));
+        return FALSE;
+    }
+    ring_ready = TRUE;
+    
+    buf_ring = io_uring_setup_buf_ring(&ring, URING_BUF_COUNT, URING_BUF_GROUP, 0, &ret);
+    if (buf_ring == NULL) {
+        log_warn("⚠️  io_uring buffer ring unavailable (%s), using GLib backend\n", strerror(-ret));
+        ingest_uring_stop();
+        return FALSE;
+    }
+    
+    buffers = g_malloc((size_t)URING_BUF_COUNT * URING_BUF_SIZE);
+    for (unsigned short bid = 0; bid < URING_BUF_COUNT; bid++) {
+        io_uring_buf_ring_add(buf_ring, buffers + (size_t)bid * URING_BUF_SIZE, URING_BUF_SIZE, bid,
+                              io_uring_buf_ring_mask(URING_BUF_COUNT), bid);
+    }
+    io_uring_buf_ring_advance(buf_ring, URING_BUF_COUNT);
+    
+    uring_clients = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, uring_client_free);
+    uring_listen_fd = listen_fd;
+    open_func = on_open;
+    line_func = on_line;
+    close_func = on_close;
+    
+    uring_arm_accept();
+    io_uring_submit(&ring);
+    
+    ring_watch = g_unix_fd_source_new(ring.ring_fd, G_IO_IN);
+    g_source_set_callback(ring_watch, G_SOURCE_FUNC(uring_ready_cb), NULL, NULL);
+    g_source_attach(ring_watch, context);
+    
+    log_info("⚡ Using io_uring ingest backend\n");
+    return TRUE;
+}
+
+void ingest_uring_stop(void) {
+    if (ring_watch) {
+        g_source_destroy(ring_watch);
+        g_source_unref(ring_watch);
+        ring_watch = NULL;
+    }
+    
+    // Tearing down the ring cancels every armed request
+    if (ring_ready) {
+        if (buf_ring) {
+            io_uring_free_buf_ring(&ring, buf_ring, URING_BUF_COUNT, URING_BUF_GROUP);
+            buf_ring = NULL;
+        }
+        io_uring_queue_exit(&ring);
+        ring_ready = FALSE;
+    }
+    
+    if (uring_clients) {
+        g_hash_table_destroy(uring_clients);
+        uring_clients = NULL;
+    }
+    g_free(buffers);
+    buffers = NULL;
+}
+
+#else /* !HAVE_IO_URING */
+
+gboolean ingest_uring_start(int listen_fd, GMainContext *context,
+                            UringOpenFunc on_open, UringLineFunc on_line, UringCloseFunc on_close) {
+    (void)listen_fd; (void)context; (void)on_open; (void)on_line; (void)on_close;
+    log_warn("⚠️  Built without io_uring support (make IO_URING=1), using GLib backend\n");
+    return FALSE;
+}
+
+void ingest_uring_stop(void) {
+}
+
+#endif /* HAVE_IO_URING */
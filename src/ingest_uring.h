@@ -0,0 +1,37 @@
+/*
+ * Optional io_uring socket backend for the ingest thread.
+ *
+ * Instead of one accept() + read() + close() round trip per producer, a
+ * single multishot accept and one multishot recv per connection (using a
+ * provided buffer ring) are kept armed, so hundreds of concurrent or
+ * persistent producers are served with a handful of syscalls per batch.
+ * Completions are picked up by polling the ring fd from the ingest
+ * GMainContext.
+ *
+ * Built only with `make IO_URING=1`; otherwise ingest_uring_start() always
+ * reports that the backend is unavailable and the GLib path is used.
+ */
+
+#ifndef INGEST_URING_H
+#define INGEST_URING_H
+
+#include <glib.h>
+
+// A connection was accepted; returns the caller's state for it
+typedef gpointer (*UringOpenFunc)(int client_fd);
+
+// Receives every complete line together with the state of its connection
+typedef void (*UringLineFunc)(char *line, gpointer connection);
+
+// The connection is about to be closed
+typedef void (*UringCloseFunc)(gpointer connection);
+
+// Start serving listen_fd through io_uring on the given context. Returns
+// FALSE (after printing why) if io_uring is not available, in which case
+// nothing was set up.
+gboolean ingest_uring_start(int listen_fd, GMainContext *context,
+                            UringOpenFunc on_open, UringLineFunc on_line, UringCloseFunc on_close);
+
+void ingest_uring_stop(void);
+
+#endif /* INGEST_URING_H */
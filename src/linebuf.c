@@ -0,0 +1,97 @@
+#include "linebuf.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+void linebuf_init(LineBuffer *buf) {
+    buf->len = 0;
+    buf->consumed = 0;
+    buf->overflow = 0;
+}
+
+// Emit every complete line currently in the buffer, then compact it
+static void linebuf_flush_lines(LineBuffer *buf, LineFunc func, void *user_data) {
+    char *start = buf->data + buf->consumed;
+    char *end = buf->data + buf->len;
+    char *newline;
+    
+    while ((newline = memchr(start, '\n', end - start)) != NULL) {
+        *newline = '\0';
+        if (newline > start && newline[-1] == '\r') {
+            newline[-1] = '\0';
+        }
+        
+        if (buf->overflow) {
+            // Tail of a line that did not fit - drop it and resync
+            buf->overflow = 0;
+        } else {
+            func(start, user_data);
+        }
+        start = newline + 1;
+    }
+    
+    buf->consumed = start - buf->data;
+    
+    // Move the partial line to the front so there is room for more input
+    if (buf->consumed > 0) {
+        size_t remaining = buf->len - buf->consumed;
+        memmove(buf->data, buf->data + buf->consumed, remaining);
+        buf->len = remaining;
+        buf->consumed = 0;
+    }
+    
+    // A full buffer without a newline can never complete - throw it away
+    if (buf->len == sizeof(buf->data)) {
+        buf->len = 0;
+        buf->overflow = 1;
+    }
+}
+
+void linebuf_feed(LineBuffer *buf, const char *bytes, size_t len, LineFunc func, void *user_data) {
+    while (len > 0) {
+        size_t space = sizeof(buf->data) - buf->len;
+        size_t chunk = len < space ? len : space;
+        
+        memcpy(buf->data + buf->len, bytes, chunk);
+        buf->len += chunk;
+        bytes += chunk;
+        len -= chunk;
+        
+        linebuf_flush_lines(buf, func, user_data);
+    }
+}
+
+ssize_t linebuf_read_fd(LineBuffer *buf, int fd, LineFunc func, void *user_data) {
+    return linebuf_read_fd_budget(buf, fd, LINEBUF_READ_BUDGET, func, user_data);
+}
+
+ssize_t linebuf_read_fd_budget(LineBuffer *buf, int fd, size_t budget, LineFunc func, void *user_data) {
+    ssize_t bytes_read = 0;
+    size_t total = 0;
+    
+    // Bounded so a producer that never pauses cannot starve the main loop;
+    // the fd stays readable and the next wakeup continues where we stopped
+    while (total < budget) {
+        bytes_read = read(fd, buf->data + buf->len, sizeof(buf->data) - buf->len);
+        if (bytes_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_read <= 0) {
+            break;
+        }
+        
+        buf->len += bytes_read;
+        total += bytes_read;
+        linebuf_flush_lines(buf, func, user_data);
+    }
+    
+    // At EOF an unterminated last line is still a complete value
+    if (bytes_read == 0 && buf->len > 0 && !buf->overflow) {
+        buf->data[buf->len] = '\0';
+        func(buf->data, user_data);
+        buf->len = 0;
+    }
+    
+    return bytes_read;
+}
@@ -0,0 +1,41 @@
+/*
+ * Fixed-size line buffer for stream inputs (stdin, spawned commands,
+ * persistent socket clients). Bytes are appended as they arrive and
+ * complete lines are handed out one at a time; a partial trailing line
+ * stays buffered until the rest of it shows up.
+ */
+
+#ifndef LINEBUF_H
+#define LINEBUF_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#define LINEBUF_SIZE 4096
+#define LINEBUF_READ_BUDGET (64 * 1024)   // Max bytes consumed per linebuf_read_fd() call
+
+typedef struct {
+    char data[LINEBUF_SIZE];
+    size_t len;         // Bytes currently buffered
+    size_t consumed;    // Bytes already handed out as lines
+    int overflow;       // Set while discarding an over-long line
+} LineBuffer;
+
+// Callback invoked for every complete line (without the trailing newline)
+typedef void (*LineFunc)(char *line, void *user_data);
+
+void linebuf_init(LineBuffer *buf);
+
+// Read whatever is available from a non-blocking fd (up to the read budget)
+// and emit every complete line. Returns the last read() result: >0 budget
+// used up with more data pending, 0 EOF, -1 error (EAGAIN means the fd is
+// simply drained).
+ssize_t linebuf_read_fd(LineBuffer *buf, int fd, LineFunc func, void *user_data);
+
+// Same with a custom budget, e.g. one buffer per call so ready inputs take turns
+ssize_t linebuf_read_fd_budget(LineBuffer *buf, int fd, size_t budget, LineFunc func, void *user_data);
+
+// Append bytes that were obtained some other way and emit complete lines
+void linebuf_feed(LineBuffer *buf, const char *bytes, size_t len, LineFunc func, void *user_data);
+
+#endif /* LINEBUF_H */
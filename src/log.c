@@ -0,0 +1,172 @@
+#include "log.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+atomic_int log_level = LOG_LEVEL_INFO;
+
+// Preallocated message ring, guarded by log_mutex
+static char ring[LOG_RING_SIZE][LOG_MESSAGE_MAX];
+static unsigned int ring_head = 0;          // Next slot to write
+static unsigned int ring_tail = 0;          // Next slot to drain
+static unsigned long ring_dropped = 0;      // Messages lost to a full ring
+static GMutex log_mutex;
+static GCond log_cond;
+static GThread *writer_thread = NULL;
+static gboolean writer_running = FALSE;
+
+// Summary counters, bumped from any thread
+static atomic_ulong updates_since_summary;
+static atomic_ulong invalid_since_summary;
+
+gboolean log_parse_level(const char *name, LogLevel *level) {
+    static const char *names[] = { "error", "warn", "info", "debug" };
+    
+    for (gsize i = 0; i < G_N_ELEMENTS(names); i++) {
+        if (g_ascii_strcasecmp(name, names[i]) == 0) {
+            *level = (LogLevel)i;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+void log_count_update(void) {
+    atomic_fetch_add_explicit(&updates_since_summary, 1, memory_order_relaxed);
+}
+
+void log_count_invalid(void) {
+    atomic_fetch_add_explicit(&invalid_since_summary, 1, memory_order_relaxed);
+}
+
+static void write_out(const char *text) {
+    fputs(text, stdout);
+}
+
+void log_message(LogLevel level, const char *format, ...) {
+    char message[LOG_MESSAGE_MAX];
+    va_list args;
+    (void)level;
+    
+    // Format outside the lock
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    
+    g_mutex_lock(&log_mutex);
+    if (!writer_running) {
+        write_out(message);
+        fflush(stdout);
+    } else if (ring_head - ring_tail == LOG_RING_SIZE) {
+        ring_dropped++;
+    } else {
+        memcpy(ring[ring_head % LOG_RING_SIZE], message, sizeof(message));
+        ring_head++;
+        g_cond_signal(&log_cond);
+    }
+    g_mutex_unlock(&log_mutex);
+}
+
+// "1234567" -> "1,234,567"
+static void format_count(char *out, size_t size, unsigned long value) {
+    char digits[32];
+    int len = snprintf(digits, sizeof(digits), "%lu", value);
+    size_t pos = 0;
+    
+    for (int i = 0; i < len && pos + 2 < size; i++) {
+        if (i > 0 && (len - i) % 3 == 0) {
+            out[pos++] = ',';
+        }
+        out[pos++] = digits[i];
+    }
+    out[pos] = '\0';
+}
+
+static void write_summary(void) {
+    unsigned long updates = atomic_exchange(&updates_since_summary, 0);
+    unsigned long invalid = atomic_exchange(&invalid_since_summary, 0);
+    
+    if (atomic_load(&log_level) < LOG_LEVEL_INFO || (updates == 0 && invalid == 0)) {
+        return;
+    }
+    
+    char updates_str[32], invalid_str[32], line[128];
+    format_count(updates_str, sizeof(updates_str), updates);
+    format_count(invalid_str, sizeof(invalid_str), invalid);
+    
+    if (invalid > 0) {
+        snprintf(line, sizeof(line), "📈 %s updates (%s invalid) in last %ds\n",
+                 updates_str, invalid_str, LOG_SUMMARY_SECONDS);
+    } else {
+        snprintf(line, sizeof(line), "📈 %s updates in last %ds\n", updates_str, LOG_SUMMARY_SECONDS);
+    }
+    write_out(line);
+}
+
+static gpointer writer_main(gpointer data) {
+    (void)data;
+    char batch[32][LOG_MESSAGE_MAX];
+    gint64 next_summary = g_get_monotonic_time() + LOG_SUMMARY_SECONDS * G_USEC_PER_SEC;
+    
+    g_mutex_lock(&log_mutex);
+    for (;;) {
+        while (writer_running && ring_head == ring_tail &&
+               g_get_monotonic_time() < next_summary) {
+            g_cond_wait_until(&log_cond, &log_mutex, next_summary);
+        }
+        
+        // Copy a batch out so the actual (possibly slow) write runs unlocked
+        unsigned int count = 0;
+        while (ring_tail != ring_head && count < G_N_ELEMENTS(batch)) {
+            memcpy(batch[count++], ring[ring_tail % LOG_RING_SIZE], LOG_MESSAGE_MAX);
+            ring_tail++;
+        }
+        unsigned long dropped = ring_dropped;
+        ring_dropped = 0;
+        gboolean running = writer_running;
+        gboolean drained = ring_tail == ring_head;
+        g_mutex_unlock(&log_mutex);
+        
+        for (unsigned int i = 0; i < count; i++) {
+            write_out(batch[i]);
+        }
+        if (dropped > 0) {
+            char line[64];
+            snprintf(line, sizeof(line), "⚠️  %lu log messages dropped\n", dropped);
+            write_out(line);
+        }
+        if (g_get_monotonic_time() >= next_summary) {
+            write_summary();
+            next_summary = g_get_monotonic_time() + LOG_SUMMARY_SECONDS * G_USEC_PER_SEC;
+        }
+        fflush(stdout);
+        
+        if (!running && drained) {
+            return NULL;
+        }
+        g_mutex_lock(&log_mutex);
+    }
+}
+
+void log_init(void) {
+    g_mutex_lock(&log_mutex);
+    if (writer_thread == NULL) {
+        writer_running = TRUE;
+        writer_thread = g_thread_new("linestatus-log", writer_main, NULL);
+    }
+    g_mutex_unlock(&log_mutex);
+}
+
+void log_shutdown(void) {
+    g_mutex_lock(&log_mutex);
+    GThread *thread = writer_thread;
+    writer_running = FALSE;
+    writer_thread = NULL;
+    g_cond_signal(&log_cond);
+    g_mutex_unlock(&log_mutex);
+    
+    if (thread) {
+        g_thread_join(thread);
+    }
+}
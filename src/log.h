@@ -0,0 +1,62 @@
+/*
+ * Leveled, asynchronous logging.
+ *
+ * Messages are formatted by the caller and copied into a preallocated ring;
+ * a writer thread drains the ring to stdout. A slow log consumer (a pipe
+ * to journald or OpenRC) therefore never stalls the GTK main loop or the
+ * ingest thread - when the ring is full, messages are dropped and counted
+ * instead. Per-update events are DEBUG, so the default INFO level only
+ * sees a rate-limited summary ("1,234 updates in last 10s").
+ *
+ * Before log_init() (and after log_shutdown()) messages are written
+ * synchronously.
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <glib.h>
+#include <stdatomic.h>
+
+typedef enum {
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG
+} LogLevel;
+
+#define LOG_RING_SIZE 256           // Queued messages
+#define LOG_MESSAGE_MAX 256         // Bytes per message, longer ones are truncated
+#define LOG_SUMMARY_SECONDS 10      // Interval of the update summary
+
+extern atomic_int log_level;
+
+// Start the writer thread
+void log_init(void);
+
+// Flush everything still queued and stop the writer thread
+void log_shutdown(void);
+
+// "error", "warn", "info" or "debug"
+gboolean log_parse_level(const char *name, LogLevel *level);
+
+void log_message(LogLevel level, const char *format, ...) G_GNUC_PRINTF(2, 3);
+
+// Count one applied update / one rejected value for the periodic summary
+void log_count_update(void);
+void log_count_invalid(void);
+
+// The level check happens before any formatting work
+#define LOG_AT(level, ...) \
+    do { \
+        if (atomic_load_explicit(&log_level, memory_order_relaxed) >= (level)) { \
+            log_message((level), __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define log_error(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define log_warn(...)  LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define log_info(...)  LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define log_debug(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#endif /* LOG_H */
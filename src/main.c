@@ -1,12 +1,13 @@
+#define _GNU_SOURCE
 #include <gtk/gtk.h>
 #include <gtk-layer-shell/gtk-layer-shell.h>
 #include <cairo.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <glib.h>
+#include <glib-unix.h>
 #include <unistd.h>
 #include <fcntl.h>
-#include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <sys/stat.h>
@@ -14,10 +15,37 @@
 #include <signal.h>
 #include <string.h>
 
+#include "ingest.h"
+#include "activation.h"
+#include "activity.h"
+#include "autohide.h"
+#include "config.h"
+#include "css.h"
+#include "history.h"
+#include "log.h"
+#include "output.h"
+#include "ratelimit.h"
+#include "present.h"
+#include "render.h"
+#include "segments.h"
+#include "source.h"
+#include "startup.h"
+#include "state.h"
+#include "stats.h"
+#include "trace.h"
+
+// One indicator window per output it is shown on
+typedef struct {
+    GtkWidget *window;
+    GtkWidget *drawing_area;
+    GdkMonitor *monitor;    // Output it is pinned to, NULL for the compositor's choice
+} Indicator;
+
 // Global variables
-static GtkWidget *window = NULL;
-static GtkWidget *drawing_area = NULL;
+static GPtrArray *indicators = NULL; // Indicator *, created on activation
+static const char *output_name = NULL; // --output NAME|INDEX|all, NULL for the compositor's choice
 static GtkCssProvider *css_provider = NULL; // Global CSS provider for cleanup
+static const char *css_override = NULL; // --css PATH instead of the embedded stylesheet
 static float current_volume = 0.7f; // Default to 70%
 static int socket_fd = -1; // Socket file descriptor
 static char socket_path[256] = {0}; // Store socket path for cleanup
@@ -30,6 +58,34 @@ static double line_blue = 0.0;
 // Debug mode for testing visibility
 static int debug_mode = 0;
 
+// Line thickness in pixels (10 in debug mode)
+static int line_thickness = 4;
+
+// --shrink: the surface is only as long as the filled part of the line
+static gboolean shrink_to_fit = FALSE;
+
+// --sparkline: recent values along the line instead of a fill level
+static History *history = NULL;
+
+// Bar style (--style, --color-stops), turned into a draw function once per configuration
+static Renderer renderer;
+static RenderStyle render_style = RENDER_BAR;
+static RenderStop color_stops[RENDER_MAX_STOPS];
+static int num_color_stops = 0;
+
+// --segments: many values (per core, per device) as segments of one line
+static Segments *segments = NULL;
+static const char *segment_colors = NULL; // --segment-colors RRGGBB,RRGGBB,... (cycled)
+static gboolean segments_changed = FALSE; // Segments set in this apply pass
+
+// --hide-after: unmap the windows after this long without updates (0 = never)
+static guint hide_after_ms = 0;
+static AutoHide autohide;
+
+// --pause-idle: no redraws after this much input inactivity (0 = only while outputs are off)
+static guint pause_idle_ms = 0;
+static gboolean redraw_suppressed = FALSE; // A value arrived while paused
+
 // RGB values as integers for display
 static int line_r = 255;
 static int line_g = 165;
@@ -43,56 +99,236 @@ static int window_x = -1; // -1 means auto-position (right edge)
 static int window_y = 0;  // 0 means top
 static const char *orientation = "vertical"; // "vertical" or "horizontal"
 
-// Screen dimensions
-static int screen_height = 1080;
+// Warm-start snapshot of value, color and geometry (NULL if not kept)
+static StateEntry *state = NULL;
+
+// Config file (--config or the default path), the look the file is merged
+// over (defaults, command line and restored snapshot) both at startup and on
+// every reload, and the fields given on the command line (the file cannot override them)
+static char *config_path = NULL;
+static ConfigSettings base_settings;
+static guint cli_fields = 0;
+
+// Optional native value source (long-running command or watched file)
+static StatusSource *value_source = NULL;
+
+// Receive/send time and trace id of the latest applied value that has not been drawn yet
+static gint64 undrawn_received = 0;
+static gint64 undrawn_sent = 0;
+static uint32_t undrawn_trace_id = 0;
+
+// Socket/stdin/source I/O runs in a separate ingest thread unless disabled
+static gboolean use_ingest_thread = TRUE;
+static gboolean use_io_uring = FALSE; // Optional io_uring socket backend
+static gboolean use_dbus = FALSE; // --dbus: export com.linestatus.Indicator on the session bus
+static double client_rate = RATELIMIT_DEFAULT_RATE; // --client-rate: messages/s per socket producer
+static double client_burst = RATELIMIT_DEFAULT_BURST;
+
+// Shrink-to-fit: the whole surface is the line, tell the compositor it need not blend it.
+// Set at draw time because GTK resets the region on every size allocation.
+static void set_opaque_region(GtkWidget *widget, int width, int height) {
+    GtkNative *native = gtk_widget_get_native(widget);
+    cairo_rectangle_int_t rect = { 0, 0, width, height };
+    cairo_region_t *region = cairo_region_create_rectangle(&rect);
+    
+    G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    gdk_surface_set_opaque_region(gtk_native_get_surface(native), region);
+    G_GNUC_END_IGNORE_DEPRECATIONS
+    cairo_region_destroy(region);
+}
 
 // Drawing function for the status line
 static void on_draw(GtkDrawingArea *drawing_area, cairo_t *cr, int width, int height, gpointer data) {
-    (void)drawing_area; (void)data;
+    (void)data;
     
-    // Clear with transparent background
-    cairo_set_source_rgba(cr, 0, 0, 0, 0);
-    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-    cairo_paint(cr);
+    stats_inc(&stats.frames_drawn);
+    if (undrawn_received != 0) {
+        stats_record_latency(undrawn_received);
+        present_track(GTK_WIDGET(drawing_area), socket_type, undrawn_received, undrawn_sent, undrawn_trace_id);
+        undrawn_received = 0;
+    }
     
-    // Set up for drawing the line with dynamic color
-    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    // One call into the style picked at configuration time
+    renderer_draw(&renderer, cr, width, height, gtk_widget_get_scale_factor(GTK_WIDGET(drawing_area)), current_volume);
+    if (shrink_to_fit) {
+        set_opaque_region(GTK_WIDGET(drawing_area), width, height);
+    }
     
-    // Use black color in debug mode for better visibility
-    if (debug_mode) {
-        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0); // Black
-    } else {
-        cairo_set_source_rgb(cr, line_red, line_green, line_blue);
+    trace_event(TRACE_DRAW_END, undrawn_trace_id, socket_type);
+    undrawn_trace_id = 0;
+    startup_first_frame();
+}
+
+// Frame clock tick that is about to paint the pending value (tracing only)
+static void on_before_paint(GdkFrameClock *clock, gpointer data) {
+    (void)data;
+    if (undrawn_trace_id != 0) {
+        trace_event_at(TRACE_FRAME_TICK, undrawn_trace_id, socket_type, gdk_frame_clock_get_frame_time(clock));
+    }
+}
+
+static void on_drawing_area_realize(GtkWidget *widget, gpointer data) {
+    (void)data;
+    g_signal_connect(gtk_widget_get_frame_clock(widget), "before-paint", G_CALLBACK(on_before_paint), NULL);
+}
+
+// SIGUSR1: dump the trace ring (runs on the main loop, not in signal context)
+static gboolean on_trace_signal(gpointer data) {
+    (void)data;
+    g_free(trace_dump());
+    return G_SOURCE_CONTINUE;
+}
+
+static void configure_layer_surface(Indicator *indicator);
+
+// Hidden after inactivity, or nothing to show in shrink-to-fit mode at 0%
+static gboolean indicator_visible(void) {
+    return !autohide.hidden && !(shrink_to_fit && current_volume <= 0);
+}
+
+static void update_visibility(void) {
+    for (guint i = 0; indicators != NULL && i < indicators->len; i++) {
+        Indicator *indicator = g_ptr_array_index(indicators, i);
+        if (indicator->window != NULL) {
+            gtk_widget_set_visible(indicator->window, indicator_visible());
+        }
     }
+}
+
+// Auto-hide timeout expired or a new value arrived while hidden
+static void on_autohide(gboolean visible, gpointer user_data) {
+    (void)user_data;
+    update_visibility();
+    log_debug(visible ? "👀 Shown again after update\n" : "🙈 Hidden after %u ms without updates\n", hide_after_ms);
+}
+
+// Show the current value on every indicator
+static void redraw_indicators(void) {
+    autohide_touch(&autohide);
     
-    // Draw based on orientation
-    if (strcmp(orientation, "vertical") == 0) {
-        // Vertical orientation - line grows from bottom
-        cairo_set_line_width(cr, width); // Use full window width for line
-        int line_height = (int)(height * current_volume);
-        int start_y = height - line_height;
-        cairo_move_to(cr, width / 2, start_y); // Center in the narrow window
-        cairo_line_to(cr, width / 2, height);
-    } else {
-        // Horizontal orientation - line grows from left
-        cairo_set_line_width(cr, height); // Use full window height for line
-        int line_width = (int)(width * current_volume);
-        cairo_move_to(cr, 0, height / 2); // Center in the narrow window
-        cairo_line_to(cr, line_width, height / 2);
+    for (guint i = 0; indicators != NULL && i < indicators->len; i++) {
+        Indicator *indicator = g_ptr_array_index(indicators, i);
+        if (indicator->drawing_area == NULL) {
+            continue;
+        }
+        if (shrink_to_fit) {
+            // A value change is a geometry change; at 0% there is nothing to show
+            configure_layer_surface(indicator);
+            gtk_widget_set_visible(indicator->window, indicator_visible());
+            gtk_widget_queue_resize(indicator->window);
+        }
+        gtk_widget_queue_draw(indicator->drawing_area);
+        stats_inc(&stats.redraws_requested);
+        trace_event(TRACE_QUEUE_DRAW, undrawn_trace_id, socket_type);
     }
-    cairo_stroke(cr);
 }
 
 // Function to set volume from socket or other source
 void set_volume(float volume) {
     // Clamp volume between 0.0 and 1.0
     current_volume = fmax(0.0f, fmin(1.0f, volume));
+    state_set_value(state, current_volume);
+    if (history != NULL) {
+        history_push(history, current_volume); // Recorded even while paused
+    }
+    
+    if (activity_is_active()) {
+        redraw_indicators();
+    } else {
+        // Nobody would see the frame: keep the value, draw it once on resume
+        redraw_suppressed = TRUE;
+        stats_inc(&stats.frames_suppressed);
+    }
     
-    if (drawing_area) {
-        gtk_widget_queue_draw(drawing_area);
+    log_count_update();
+    log_debug("🔊 Volume updated to: %.0f%%\n", current_volume * 100);
+}
+
+// Pick the draw function for the current settings; runs again whenever they change
+static void configure_renderer(void) {
+    RenderStyle style = render_style;
+    
+    if (segments != NULL) {
+        style = RENDER_SEGMENTED;
+    } else if (history != NULL) {
+        style = RENDER_SPARKLINE;
+    } else if (shrink_to_fit) {
+        style = RENDER_FILL;
     }
+    renderer.segments = segments;
+    renderer.history = history;
+    
+    // Black in debug mode for better visibility
+    renderer_configure(&renderer, style, strcmp(orientation, "vertical") == 0,
+                       debug_mode ? 0.0 : line_red, debug_mode ? 0.0 : line_green, debug_mode ? 0.0 : line_blue,
+                       color_stops, num_color_stops);
+}
+
+// One segment of a segmented line; the line as a whole (state, logs, redraw)
+// follows once per apply pass, in on_updates_applied()
+static void set_segment(guint index, float value) {
+    segments_set(segments, index, fmax(0.0f, fmin(1.0f, value)));
+    segments_changed = TRUE;
+}
+
+// Segment colors from --segment-colors, else the line color with every other segment dimmed
+static void apply_segment_colors(void) {
+    char **colors = segment_colors != NULL ? g_strsplit(segment_colors, ",", -1) : NULL;
+    guint num_colors = colors != NULL ? g_strv_length(colors) : 0;
     
-    printf("🔊 Volume updated to: %.0f%%\n", current_volume * 100);
+    for (guint i = 0; segments != NULL && i < segments_count(segments); i++) {
+        double r = line_red, g = line_green, b = line_blue;
+        double dim = i % 2 == 1 ? 0.75 : 1.0;
+        if (num_colors > 0) {
+            dim = 1.0;
+            if (!config_parse_color(colors[i % num_colors], &r, &g, &b)) {
+                log_warn("⚠️  Invalid segment color '%s'\n", colors[i % num_colors]);
+            }
+        }
+        segments_set_color(segments, i, r * dim, g * dim, b * dim);
+    }
+    g_strfreev(colors);
+}
+
+// The user came back or an output was powered on: catch up in a single frame
+static void on_activity_changed(gboolean active, gpointer user_data) {
+    (void)user_data;
+    if (!active || !redraw_suppressed) {
+        return;
+    }
+    redraw_suppressed = FALSE;
+    undrawn_received = 0; // Held back on purpose, not render latency
+    undrawn_sent = 0;
+    redraw_indicators();
+}
+
+// Apply an update handed over by the ingest thread (runs on the GTK thread)
+static void apply_update(const Update *update, gpointer user_data) {
+    (void)user_data;
+    
+    if (strcmp(update->key, socket_type) == 0) {
+        trace_event(TRACE_APPLY, update->trace_id, update->key);
+        trace_event(TRACE_COALESCED, undrawn_trace_id, update->key); // Replaced before it was drawn
+        undrawn_received = update->received;
+        undrawn_sent = update->sent;
+        undrawn_trace_id = update->trace_id;
+        if (segments != NULL) {
+            set_segment(update->index, update->value);
+        } else {
+            set_volume(update->value);
+        }
+    } else {
+        log_warn("⚠️  Unknown key received: %s\n", update->key);
+    }
+}
+
+// End of an apply pass: a whole vector message becomes one line update
+static void on_updates_applied(gpointer user_data) {
+    (void)user_data;
+    if (segments_changed) {
+        segments_changed = FALSE;
+        set_volume(segments_mean(segments));
+    }
 }
 
 // Function to create Unix domain socket
@@ -122,8 +358,8 @@ static int create_socket(const char *socket_path) {
         return -1;
     }
     
-    // Listen for connections
-    if (listen(fd, 5) < 0) {
+    // Listen for connections - a deep backlog absorbs bursts of one-shot senders
+    if (listen(fd, SOMAXCONN) < 0) {
         perror("listen");
         close(fd);
         return -1;
@@ -135,77 +371,18 @@ static int create_socket(const char *socket_path) {
     return fd;
 }
 
-// Function to handle socket connections
-static gboolean handle_socket(gpointer user_data) {
-    (void)user_data;
-    
-    if (socket_fd < 0) {
-        return G_SOURCE_CONTINUE;
-    }
-    
-    // Check if there's a connection
-    fd_set read_fds;
-    FD_ZERO(&read_fds);
-    FD_SET(socket_fd, &read_fds);
-    
-    struct timeval timeout = {0, 0}; // Non-blocking check
-    if (select(socket_fd + 1, &read_fds, NULL, NULL, &timeout) > 0) {
-        if (FD_ISSET(socket_fd, &read_fds)) {
-            // Accept connection
-            struct sockaddr_un client_addr;
-            socklen_t client_len = sizeof(client_addr);
-            int client_fd = accept(socket_fd, (struct sockaddr *)&client_addr, &client_len);
-            
-            if (client_fd >= 0) {
-                // Read data from client
-                char buffer[32];
-                ssize_t bytes_read = read(client_fd, buffer, sizeof(buffer) - 1);
-                
-                if (bytes_read > 0) {
-                    buffer[bytes_read] = '\0';
-                    
-                    // Parse the volume value
-                    char *endptr;
-                    long volume_percent = strtol(buffer, &endptr, 10);
-                    
-                    if (endptr != buffer && volume_percent >= 0 && volume_percent <= 100) {
-                        set_volume(volume_percent / 100.0f);
-                    } else {
-                        printf("⚠️  Invalid volume value: %s", buffer);
-                    }
-                }
-                
-                close(client_fd);
-            }
-        }
-    }
-    
-    return G_SOURCE_CONTINUE; // Keep checking
+// SIGINT/SIGTERM: leave the main loop so main() cleans up (runs on the main loop, not in signal context)
+static gboolean on_quit_signal(gpointer data) {
+    log_info("🧹 Signal received, shutting down...\n");
+    g_application_quit(G_APPLICATION(data));
+    return G_SOURCE_CONTINUE;
 }
 
-// Signal handler for cleanup
-static void cleanup_and_exit(int sig) {
-    (void)sig; // Unused parameter
-    
-    printf("\n🧹 Received signal %d, cleaning up...\n", sig);
-    
-    // Cleanup CSS provider
-    if (css_provider != NULL) {
-        g_object_unref(css_provider);
-        printf("🧹 CSS provider cleaned up\n");
-    }
-    
-    // Cleanup socket
-    if (socket_fd >= 0) {
-        close(socket_fd);
-        if (socket_path[0] != '\0') {
-            unlink(socket_path); // Remove socket file
-            printf("🗑️  Removed socket: %s\n", socket_path);
-        }
-    }
-    
-    printf("👋 Exiting gracefully...\n");
-    exit(0);
+// SIGHUP: re-read the config file
+static gboolean on_reload_signal(gpointer data) {
+    (void)data;
+    config_reload();
+    return G_SOURCE_CONTINUE;
 }
 
 // Function to parse hex color string to RGB components
@@ -219,212 +396,516 @@ static void parse_hex_color(const char *hex_str) {
         return;
     }
     
-    // Remove # if present
-    const char *color_str = hex_str;
-    if (hex_str[0] == '#') {
-        color_str = hex_str + 1;
-    }
-    
-    // Parse hex string
-    unsigned int r, g, b;
-    if (sscanf(color_str, "%02x%02x%02x", &r, &g, &b) == 3) {
-        // Convert to 0.0-1.0 range
-        line_red = r / 255.0;
-        line_green = g / 255.0;
-        line_blue = b / 255.0;
-        
+    if (config_parse_color(hex_str, &line_red, &line_green, &line_blue)) {
         // Store integer values for display
-        line_r = r;
-        line_g = g;
-        line_b = b;
+        line_r = (int)(line_red * 255 + 0.5);
+        line_g = (int)(line_green * 255 + 0.5);
+        line_b = (int)(line_blue * 255 + 0.5);
     } else {
-        printf("⚠️  Invalid color format '%s', using default orange\n", hex_str);
+        log_warn("⚠️  Invalid color format '%s', using default orange\n", hex_str);
     }
 }
 
-// Function to read volume from stdin using timeout
-static gboolean check_stdin(gpointer user_data) {
-    (void)user_data;
-    
-    // Check if there's data available on stdin
-    fd_set read_fds;
-    FD_ZERO(&read_fds);
-    FD_SET(STDIN_FILENO, &read_fds);
-    
-    struct timeval timeout = {0, 0}; // Non-blocking check
-    if (select(STDIN_FILENO + 1, &read_fds, NULL, NULL, &timeout) > 0) {
-        if (FD_ISSET(STDIN_FILENO, &read_fds)) {
-            char buffer[32];
-            if (fgets(buffer, sizeof(buffer), stdin) != NULL) {
-                // Parse the volume value
-                char *endptr;
-                long volume_percent = strtol(buffer, &endptr, 10);
-                
-                if (endptr != buffer && volume_percent >= 0 && volume_percent <= 100) {
-                    set_volume(volume_percent / 100.0f);
-                } else {
-                    printf("⚠️  Invalid volume value: %s", buffer);
-                }
-            }
-        }
-    }
-    
-    return G_SOURCE_CONTINUE; // Keep the timeout running
+// The look as it is now
+static void get_settings(ConfigSettings *settings) {
+    settings->set = 0;
+    settings->r = line_red;
+    settings->g = line_green;
+    settings->b = line_blue;
+    settings->x = window_x;
+    settings->y = window_y;
+    settings->vertical = strcmp(orientation, "vertical") == 0;
+    settings->thickness = line_thickness;
 }
 
+static void set_settings(const ConfigSettings *settings) {
+    line_red = settings->r;
+    line_green = settings->g;
+    line_blue = settings->b;
+    line_r = (int)(line_red * 255 + 0.5);
+    line_g = (int)(line_green * 255 + 0.5);
+    line_b = (int)(line_blue * 255 + 0.5);
+    window_x = settings->x;
+    window_y = settings->y;
+    orientation = settings->vertical ? "vertical" : "horizontal";
+    line_thickness = settings->thickness;
+}
 
+// Remember color and geometry in the warm-start snapshot
+static void save_state_look(void) {
+    if (state == NULL) {
+        return;
+    }
+    state->r = line_red;
+    state->g = line_green;
+    state->b = line_blue;
+    state->x = window_x;
+    state->y = window_y;
+    state->vertical = strcmp(orientation, "vertical") == 0;
+}
 
-// Activate function - creates the window
-static void on_activate(GtkApplication *app, gpointer user_data) {
-    (void)app; (void)user_data;
+// Size, anchors and margins of the layer surface, from the geometry of the
+// output it is on; used when the window is created and again when the config
+// or the output changes
+static void configure_layer_surface(Indicator *indicator) {
+    GtkWindow *win = GTK_WINDOW(indicator->window);
+    GdkMonitor *monitor = indicator->monitor != NULL ? indicator->monitor : output_for_widget(indicator->window);
+    gboolean vertical = strcmp(orientation, "vertical") == 0;
+    int output_width, output_height, width, height;
     
-    // Create the main window
-    window = gtk_application_window_new(app);
-    gtk_window_set_title(GTK_WINDOW(window), "LineStatus");
+    // Exactly the visible size: the buffer GTK allocates at the output's scale then
+    // matches the output's pixels and nothing is rescaled or left transparent
+    output_get_size(monitor, &output_width, &output_height);
+    if (vertical) {
+        width = line_thickness; // Narrow, full height below the position
+        height = window_x == -1 ? output_height : MAX(output_height - window_y, 1);
+    } else {
+        width = window_x == -1 ? output_width : MAX(output_width - window_x, 1);
+        height = line_thickness; // Full width right of the position, narrow
+    }
     
-    // Set window size based on orientation
-    if (strcmp(orientation, "vertical") == 0) {
-        // Make window wider in debug mode for better visibility
-        if (debug_mode) {
-            gtk_window_set_default_size(GTK_WINDOW(window), 10, screen_height); // 10px wide, full height
+    // Shrink-to-fit: only the filled part, anchored to the edge the line grows from
+    if (shrink_to_fit) {
+        int *length = vertical ? &height : &width;
+        *length = MAX((int)(*length * current_volume + 0.5), 1);
+    }
+    gtk_window_set_default_size(win, width, height);
+    if (indicator->drawing_area != NULL) {
+        gtk_widget_set_size_request(indicator->drawing_area, width, height);
+    }
+    
+    // Start from a clean slate so a switch leaves no stale anchor behind
+    gtk_layer_set_anchor(win, GTK_LAYER_SHELL_EDGE_LEFT, FALSE);
+    gtk_layer_set_anchor(win, GTK_LAYER_SHELL_EDGE_TOP, FALSE);
+    gtk_layer_set_anchor(win, GTK_LAYER_SHELL_EDGE_RIGHT, FALSE);
+    gtk_layer_set_anchor(win, GTK_LAYER_SHELL_EDGE_BOTTOM, FALSE);
+    gtk_layer_set_margin(win, GTK_LAYER_SHELL_EDGE_LEFT, 0);
+    gtk_layer_set_margin(win, GTK_LAYER_SHELL_EDGE_TOP, 0);
+    gtk_layer_set_margin(win, GTK_LAYER_SHELL_EDGE_RIGHT, 0);
+    gtk_layer_set_margin(win, GTK_LAYER_SHELL_EDGE_BOTTOM, 0);
+    
+    // Set positioning based on user input
+    if (shrink_to_fit) {
+        // Vertical lines grow from the bottom, horizontal ones from the left
+        if (window_x == -1) {
+            gtk_layer_set_anchor(win, vertical ? GTK_LAYER_SHELL_EDGE_RIGHT : GTK_LAYER_SHELL_EDGE_LEFT, TRUE);
         } else {
-            gtk_window_set_default_size(GTK_WINDOW(window), 4, screen_height); // 4px wide, full height
+            gtk_layer_set_anchor(win, GTK_LAYER_SHELL_EDGE_LEFT, TRUE);
+            gtk_layer_set_margin(win, GTK_LAYER_SHELL_EDGE_LEFT, window_x);
+        }
+        if (vertical) {
+            gtk_layer_set_anchor(win, GTK_LAYER_SHELL_EDGE_BOTTOM, TRUE);
+        } else if (window_x != -1) {
+            gtk_layer_set_anchor(win, GTK_LAYER_SHELL_EDGE_TOP, TRUE);
+            gtk_layer_set_margin(win, GTK_LAYER_SHELL_EDGE_TOP, window_y);
+        }
+    } else if (window_x == -1) {
+        // Auto-position on right edge (default behavior), stretched along the
+        // line by the compositor so it always spans the whole output
+        gtk_layer_set_anchor(win, GTK_LAYER_SHELL_EDGE_RIGHT, TRUE);
+        gtk_layer_set_anchor(win, vertical ? GTK_LAYER_SHELL_EDGE_TOP : GTK_LAYER_SHELL_EDGE_LEFT, TRUE);
+        if (vertical) {
+            gtk_layer_set_anchor(win, GTK_LAYER_SHELL_EDGE_BOTTOM, TRUE);
         }
     } else {
-        // Make window taller in debug mode for better visibility
-        if (debug_mode) {
-            gtk_window_set_default_size(GTK_WINDOW(window), screen_height, 10); // Full width, 10px tall
-        } else {
-            gtk_window_set_default_size(GTK_WINDOW(window), screen_height, 4); // Full width, 4px tall
+        // Custom positioning - anchor to left and top edges, margins are the offsets
+        gtk_layer_set_anchor(win, GTK_LAYER_SHELL_EDGE_LEFT, TRUE);
+        gtk_layer_set_anchor(win, GTK_LAYER_SHELL_EDGE_TOP, TRUE);
+        gtk_layer_set_margin(win, GTK_LAYER_SHELL_EDGE_LEFT, window_x);
+        gtk_layer_set_margin(win, GTK_LAYER_SHELL_EDGE_TOP, window_y);
+    }
+    
+    log_debug("📐 Output %s (%dx%d @ %.2fx): surface %dx%d\n", output_get_name(monitor),
+              output_width, output_height, output_get_scale(monitor), width, height);
+}
+
+static void configure_all_layer_surfaces(void) {
+    for (guint i = 0; indicators != NULL && i < indicators->len; i++) {
+        Indicator *indicator = g_ptr_array_index(indicators, i);
+        if (indicator->window != NULL) {
+            configure_layer_surface(indicator);
+            gtk_widget_queue_resize(indicator->window);
         }
     }
-    gtk_window_set_resizable(GTK_WINDOW(window), FALSE);
+}
+
+// The compositor closes the layer surface when its output goes away
+static void on_indicator_destroy(GtkWidget *widget, gpointer data) {
+    Indicator *indicator = data;
+    (void)widget;
+    indicator->window = NULL;
+    indicator->drawing_area = NULL;
+}
+
+// Window, layer surface and drawing area on one output (not presented yet)
+static Indicator *indicator_new(GtkApplication *app, GdkMonitor *monitor) {
+    Indicator *indicator = g_new0(Indicator, 1);
+    indicator->monitor = monitor;
     
-    // Set up layer shell for proper overlay positioning
-    gtk_layer_init_for_window(GTK_WINDOW(window));
-    gtk_layer_set_layer(GTK_WINDOW(window), GTK_LAYER_SHELL_LAYER_OVERLAY);
+    // Create the main window
+    indicator->window = gtk_application_window_new(app);
+    gtk_window_set_title(GTK_WINDOW(indicator->window), "LineStatus");
+    gtk_window_set_resizable(GTK_WINDOW(indicator->window), FALSE);
     
-    // Set positioning based on user input
-    if (window_x == -1) {
-        // Auto-position on right edge (default behavior)
-        gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_RIGHT, TRUE);
-        gtk_layer_set_margin(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_RIGHT, 0);
-    } else {
-        // Custom positioning - use layer shell anchoring with margins
-        // For left/top positioning, anchor to left and top edges with margins
-        gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_LEFT, TRUE);
-        gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_TOP, TRUE);
-        gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_RIGHT, FALSE);
-        gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_BOTTOM, FALSE);
-        
-        // Set margins as offsets from the anchored edges
-        gtk_layer_set_margin(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_LEFT, window_x);
-        gtk_layer_set_margin(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_TOP, window_y);
+    // Set up layer shell for proper overlay positioning
+    gtk_layer_init_for_window(GTK_WINDOW(indicator->window));
+    gtk_layer_set_layer(GTK_WINDOW(indicator->window), GTK_LAYER_SHELL_LAYER_OVERLAY);
+    if (monitor != NULL) {
+        gtk_layer_set_monitor(GTK_WINDOW(indicator->window), monitor);
     }
     
     // No exclusive zone - don't reserve space
-    gtk_layer_set_exclusive_zone(GTK_WINDOW(window), -1);
+    gtk_layer_set_exclusive_zone(GTK_WINDOW(indicator->window), -1);
     
     // Note: Window is naturally non-interactive since it's very narrow
     // Clicks will pass through to applications behind it
     
-    // Apply CSS for transparency
-    css_provider = gtk_css_provider_new();
+    // Create drawing area for custom drawing
+    indicator->drawing_area = gtk_drawing_area_new();
+    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(indicator->drawing_area), on_draw, NULL, NULL);
+    gtk_widget_set_hexpand(indicator->drawing_area, TRUE);
+    gtk_widget_set_vexpand(indicator->drawing_area, TRUE);
+    if (trace_enabled) {
+        g_signal_connect(indicator->drawing_area, "realize", G_CALLBACK(on_drawing_area_realize), NULL);
+    }
     
-    // Try different paths for CSS file
-    const char *css_paths[] = {
-        "src/style.css",
-        "style.css",
-        "/home/ljuc/projects/linestatus/src/style.css",
-        "/home/ljuc/projects/linestatus/style.css"
-    };
+    // Set window child
+    gtk_window_set_child(GTK_WINDOW(indicator->window), indicator->drawing_area);
+    configure_layer_surface(indicator);
+    g_signal_connect(indicator->window, "destroy", G_CALLBACK(on_indicator_destroy), indicator);
+    return indicator;
+}
+
+static void indicator_free(Indicator *indicator) {
+    if (indicator->window != NULL) {
+        g_signal_handlers_disconnect_by_func(indicator->window, on_indicator_destroy, indicator);
+        gtk_window_destroy(GTK_WINDOW(indicator->window));
+    }
+    g_free(indicator);
+}
+
+// One indicator on the chosen output, on every output, or where the compositor puts it
+static void build_indicators(GtkApplication *app) {
+    if (output_name != NULL && strcmp(output_name, "all") == 0) {
+        GListModel *monitors = gdk_display_get_monitors(gdk_display_get_default());
+        for (guint i = 0; i < g_list_model_get_n_items(monitors); i++) {
+            GdkMonitor *monitor = g_list_model_get_item(monitors, i);
+            g_ptr_array_add(indicators, indicator_new(app, monitor));
+            g_object_unref(monitor); // The display keeps it alive while it is connected
+        }
+        return;
+    }
     
-    gboolean css_loaded = FALSE;
-    for (gsize i = 0; i < G_N_ELEMENTS(css_paths); i++) {
-        if (g_file_test(css_paths[i], G_FILE_TEST_EXISTS)) {
-            gtk_css_provider_load_from_path(css_provider, css_paths[i]);
-            css_loaded = TRUE;
-            printf("🎨 CSS loaded from: %s\n", css_paths[i]);
-            break;
-        } else {
-            printf("🔍 CSS file not found: %s\n", css_paths[i]);
+    GdkMonitor *monitor = NULL;
+    if (output_name != NULL && (monitor = output_find(output_name)) == NULL) {
+        log_warn("⚠️  Output %s is not connected, using the compositor's choice until it is\n", output_name);
+    }
+    g_ptr_array_add(indicators, indicator_new(app, monitor));
+}
+
+// Outputs were plugged, unplugged or changed mode/scale: rebuild on the new set
+static void on_outputs_changed(gpointer user_data) {
+    GtkApplication *app = user_data;
+    
+    g_ptr_array_set_size(indicators, 0);
+    build_indicators(app);
+    for (guint i = 0; i < indicators->len; i++) {
+        Indicator *indicator = g_ptr_array_index(indicators, i);
+        if (indicator->window != NULL && indicator_visible()) {
+            gtk_window_present(GTK_WINDOW(indicator->window));
         }
     }
+    log_info("🖥️  %u indicator window(s) after output change\n", indicators->len);
+}
+
+// The config file changed: apply what differs from what is on screen
+static void on_config_changed(const ConfigSettings *file, gpointer user_data) {
+    (void)user_data;
+    ConfigSettings now, next = base_settings;
+    
+    config_merge(&next, file, cli_fields);
+    get_settings(&now);
+    guint changed = config_diff(&now, &next);
+    if (changed == 0) {
+        return;
+    }
     
-    if (!css_loaded) {
-        printf("⚠️  Could not load CSS file, transparency may not work perfectly\n");
+    set_settings(&next);
+    save_state_look();
+    if (changed & (CONFIG_POSITION | CONFIG_ORIENTATION | CONFIG_THICKNESS)) {
+        configure_all_layer_surfaces();
+    }
+    if (changed & CONFIG_COLOR) {
+        apply_segment_colors();
+    }
+    if (changed & (CONFIG_COLOR | CONFIG_ORIENTATION)) {
+        configure_renderer();
+    }
+    for (guint i = 0; indicators != NULL && i < indicators->len; i++) {
+        Indicator *indicator = g_ptr_array_index(indicators, i);
+        if (indicator->drawing_area != NULL) {
+            gtk_widget_queue_draw(indicator->drawing_area);
+        }
+    }
+    log_info("🎨 Config applied:%s%s%s%s\n",
+             changed & CONFIG_COLOR ? " color" : "",
+             changed & CONFIG_POSITION ? " position" : "",
+             changed & CONFIG_ORIENTATION ? " orientation" : "",
+             changed & CONFIG_THICKNESS ? " thickness" : "");
+}
+
+// GTK is initialized and the application registered
+static void on_startup(GtkApplication *app, gpointer user_data) {
+    (void)app; (void)user_data;
+    startup_mark("gtk_init");
+}
+
+// The application is going down: drop the windows while they still exist
+static void on_shutdown(GtkApplication *app, gpointer user_data) {
+    (void)app; (void)user_data;
+    autohide_clear(&autohide);
+    activity_unwatch();
+    output_unwatch();
+    if (indicators != NULL) {
+        g_ptr_array_free(indicators, TRUE);
+        indicators = NULL;
     }
+}
+
+// Activate function - creates the window
+static void on_activate(GtkApplication *app, gpointer user_data) {
+    (void)user_data;
     
-    gtk_style_context_add_provider_for_display(
-        gdk_display_get_default(),
-        GTK_STYLE_PROVIDER(css_provider),
-        GTK_STYLE_PROVIDER_PRIORITY_APPLICATION
-    );
+    // A second plain launch only activates the primary again; keep the one
+    // window, and leave gone outputs and auto-hidden / empty lines alone
+    if (indicators != NULL) {
+        for (guint i = 0; i < indicators->len; i++) {
+            Indicator *indicator = g_ptr_array_index(indicators, i);
+            if (indicator->window != NULL && indicator_visible()) {
+                gtk_window_present(GTK_WINDOW(indicator->window));
+            }
+        }
+        return;
+    }
     
-    // Create drawing area for custom drawing
-    drawing_area = gtk_drawing_area_new();
-    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(drawing_area), on_draw, NULL, NULL);
-    gtk_widget_set_hexpand(drawing_area, TRUE);
-    gtk_widget_set_vexpand(drawing_area, TRUE);
+    // Apply CSS for transparency (embedded unless overridden with --css)
+    css_provider = css_install(css_override);
+    startup_mark("css");
     
-    // Set window child
-    gtk_window_set_child(GTK_WINDOW(window), drawing_area);
+    // Indicator windows sized from the real outputs, rebuilt when they change.
+    // Windows come and go with outputs, so the application must not quit
+    // when the last one is gone.
+    indicators = g_ptr_array_new_with_free_func((GDestroyNotify)indicator_free);
+    build_indicators(app);
+    output_watch(on_outputs_changed, app);
+    activity_watch(pause_idle_ms, on_activity_changed, NULL);
+    g_application_hold(G_APPLICATION(app));
+    startup_mark("layer_shell");
     
-    // Show the window
-    gtk_window_present(GTK_WINDOW(window));
+    if (trace_enabled) {
+        g_unix_signal_add(SIGUSR1, on_trace_signal, NULL);
+    }
     
     // Create Unix domain socket for status updates
+    IngestConfig ingest = {
+        .listen_fd = -1,
+        .watch_stdin = FALSE,
+        .sources = NULL,
+        .default_key = socket_type,
+        .threaded = use_ingest_thread,
+        .io_uring = use_io_uring,
+        .client_rate = client_rate,
+        .client_burst = client_burst,
+        .bus = NULL,
+        .bus_path = NULL,
+        .apply = apply_update,
+        .applied = on_updates_applied,
+        .user_data = NULL,
+    };
+    
+    // Same ingest path as the socket, on the bus name the application already owns
+    if (use_dbus) {
+        ingest.bus = g_application_get_dbus_connection(G_APPLICATION(app));
+        ingest.bus_path = g_application_get_dbus_object_path(G_APPLICATION(app));
+        if (ingest.bus == NULL) {
+            log_warn("⚠️  No session bus, D-Bus interface disabled\n");
+        }
+    }
+    
     const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
-    if (runtime_dir) {
+    if (socket_fd >= 0) {
+        // Socket activation: the service manager owns the socket file
+        ingest.listen_fd = socket_fd;
+    } else if (runtime_dir) {
         snprintf(socket_path, sizeof(socket_path), "%s/linestatus-%s.sock", runtime_dir, socket_type);
         
         socket_fd = create_socket(socket_path);
         if (socket_fd >= 0) {
-            printf("Socket created at: %s\n", socket_path);
-            g_timeout_add(100, handle_socket, NULL);
+            log_info("Socket created at: %s\n", socket_path);
+            ingest.listen_fd = socket_fd;
         } else {
-            printf("Failed to create socket, falling back to stdin\n");
-            g_timeout_add(100, check_stdin, NULL);
+            log_warn("Failed to create socket, falling back to stdin\n");
+            ingest.watch_stdin = TRUE;
         }
     } else {
-        printf("XDG_RUNTIME_DIR not set, using stdin\n");
-        g_timeout_add(100, check_stdin, NULL);
+        log_warn("XDG_RUNTIME_DIR not set, using stdin\n");
+        ingest.watch_stdin = TRUE;
+    }
+    
+    // A pipe on stdin (meter | linestatus) streams alongside the socket
+    struct stat stdin_stat;
+    if (ingest.listen_fd >= 0 && fstat(STDIN_FILENO, &stdin_stat) == 0 &&
+        (S_ISFIFO(stdin_stat.st_mode) || S_ISSOCK(stdin_stat.st_mode))) {
+        log_info("Also reading updates from stdin\n");
+        ingest.watch_stdin = TRUE;
     }
     
-    // Set up signal handlers for graceful cleanup
-    signal(SIGINT, cleanup_and_exit);  // Ctrl+C
-    signal(SIGTERM, cleanup_and_exit); // Termination signal
+    // The native value source, if one was configured, is driven by ingest too
+    if (value_source != NULL) {
+        ingest.sources = g_ptr_array_new_with_free_func((GDestroyNotify)source_free);
+        g_ptr_array_add(ingest.sources, value_source);
+        value_source = NULL;
+    }
     
-    printf("LineStatus started (type: %s)\n", socket_type);
+    if (!ingest_start(&ingest)) {
+        log_warn("⚠️  Failed to start ingest thread\n");
+    }
+    startup_mark("socket");
+    
+    // Show the windows only now, so values that were queued on the socket
+    // before we started are applied before the first frame
+    autohide_init(&autohide, hide_after_ms, on_autohide, NULL);
+    for (guint i = 0; i < indicators->len; i++) {
+        Indicator *indicator = g_ptr_array_index(indicators, i);
+        if (indicator->window != NULL) {
+            gtk_window_present(GTK_WINDOW(indicator->window));
+        }
+    }
+    startup_mark("window");
+    
+    // Signals are dispatched from the main loop: quit cleanly, reload the config
+    g_unix_signal_add(SIGINT, on_quit_signal, app);  // Ctrl+C
+    g_unix_signal_add(SIGTERM, on_quit_signal, app); // Termination signal
+    g_unix_signal_add(SIGHUP, on_reload_signal, NULL);
+    
+    log_info("LineStatus started (type: %s)\n", socket_type);
     if (debug_mode) {
-        printf("🐞 DEBUG MODE: Using black line for better visibility\n");
+        log_info("🐞 DEBUG MODE: Using black line for better visibility\n");
     }
     if (strcmp(orientation, "vertical") == 0) {
-        if (debug_mode) {
-        printf("Narrow window (10px wide × %dpx tall) - DEBUG MODE\n", screen_height);
-    } else {
-        printf("Narrow window (4px wide × %dpx tall)\n", screen_height);
-    }
+        log_info("Narrow window (%dpx wide, output height)%s\n", line_thickness,
+                 debug_mode ? " - DEBUG MODE" : "");
         if (!debug_mode) {
-            printf("Line height = volume level (RGB: %d, %d, %d)\n", line_r, line_g, line_b);
+            log_info("Line height = volume level (RGB: %d, %d, %d)\n", line_r, line_g, line_b);
         } else {
-            printf("Line height = volume level (RGB: 0, 0, 0 - BLACK)\n");
+            log_info("Line height = volume level (RGB: 0, 0, 0 - BLACK)\n");
         }
     } else {
-    if (debug_mode) {
-        printf("Wide window (%dpx wide × 10px tall) - DEBUG MODE\n", screen_height);
-    } else {
-        printf("Wide window (%dpx wide × 4px tall)\n", screen_height);
-    }
+        log_info("Wide window (output width, %dpx tall)%s\n", line_thickness,
+                 debug_mode ? " - DEBUG MODE" : "");
         if (!debug_mode) {
-            printf("Line width = volume level (RGB: %d, %d, %d)\n", line_r, line_g, line_b);
+            log_info("Line width = volume level (RGB: %d, %d, %d)\n", line_r, line_g, line_b);
         } else {
-            printf("Line width = volume level (RGB: 0, 0, 0 - BLACK)\n");
+            log_info("Line width = volume level (RGB: 0, 0, 0 - BLACK)\n");
+        }
+    }
+    log_info("Outputs: %s (%u window(s))\n", output_name != NULL ? output_name : "compositor's choice", indicators->len);
+    log_info("Initial volume: %.0f%%\n", current_volume * 100);
+    log_info("Clicks pass through - no interference\n");
+    log_info("Send updates to socket: echo 60 > $XDG_RUNTIME_DIR/linestatus-%s.sock\n", socket_type);
+}
+
+// Come up with the value this type showed last; explicit options still win
+static void restore_state(void) {
+    gboolean restored;
+    
+    if (!state_open(socket_type) || (state = state_entry(socket_type, &restored)) == NULL) {
+        return;
+    }
+    
+    if (restored) {
+        current_volume = state->value;
+        if (!(cli_fields & CONFIG_COLOR)) {
+            line_red = state->r;
+            line_green = state->g;
+            line_blue = state->b;
+            line_r = (int)(line_red * 255 + 0.5);
+            line_g = (int)(line_green * 255 + 0.5);
+            line_b = (int)(line_blue * 255 + 0.5);
+        }
+        if (!(cli_fields & CONFIG_POSITION)) {
+            window_x = (int)state->x;
+            window_y = (int)state->y;
+        }
+        if (!(cli_fields & CONFIG_ORIENTATION)) {
+            orientation = state->vertical ? "vertical" : "horizontal";
         }
+        log_info("💾 Restored %s at %.0f%% from the last run\n", socket_type, current_volume * 100);
     }
-    printf("Initial volume: %.0f%%\n", current_volume * 100);
-    printf("Clicks pass through - no interference\n");
-    printf("Send updates to socket: echo 60 > $XDG_RUNTIME_DIR/linestatus-%s.sock\n", socket_type);
+    
+    // Snapshot what this run actually uses
+    state->value = current_volume;
+    save_state_look();
+}
+
+// Percentage argument of --set/--inc/--dec (0-100)
+static gboolean parse_percent(const char *str, double *percent) {
+    char *end = NULL;
+    double value = g_ascii_strtod(str, &end);
+    if (end == str || *end != '\0' || value < 0 || value > 100) {
+        return FALSE;
+    }
+    *percent = value;
+    return TRUE;
+}
+
+// Hand a value from the command line to ingest like any socket update, so
+// it is ordered with values that are still on their way to the GTK thread
+static void apply_command_line_value(float value, gboolean relative) {
+    Update update = {0};
+    g_strlcpy(update.key, socket_type, sizeof(update.key));
+    update.value = relative ? value : fmax(0.0f, fmin(1.0f, value));
+    ingest_submit(&update, relative);
+}
+
+// Command line of this or a remote instance: --set N, --inc [N], --dec [N]
+static int on_command_line(GApplication *app, GApplicationCommandLine *cmdline, gpointer user_data) {
+    (void)user_data;
+    int argc;
+    char **argv = g_application_command_line_get_arguments(cmdline, &argc);
+    gboolean handled = FALSE;
+    int status = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        gboolean set = strcmp(argv[i], "--set") == 0;
+        gboolean inc = strcmp(argv[i], "--inc") == 0;
+        gboolean dec = strcmp(argv[i], "--dec") == 0;
+        if (!set && !inc && !dec) {
+            continue;
+        }
+        
+        double percent = 5; // Default step for --inc/--dec
+        if (i + 1 < argc && parse_percent(argv[i + 1], &percent)) {
+            i++;
+        } else if (set) {
+            g_application_command_line_printerr(cmdline, "❌ Error: --set requires a value between 0 and 100\n");
+            status = 1;
+            break;
+        }
+        
+        // --inc/--dec step from the latest received value, not the drawn one
+        float value = percent / 100.0;
+        apply_command_line_value(dec ? -value : value, inc || dec);
+        handled = TRUE;
+    }
+    
+    // Anything else is a regular launch
+    if (!handled && status == 0) {
+        g_application_activate(app);
+    }
+    
+    g_strfreev(argv);
+    return status;
 }
 
 // Function to remove processed arguments from argv
@@ -436,12 +917,16 @@ static void remove_arguments(int *argc, char ***argv, int start_index, int count
 }
 
 int main(int argc, char **argv) {
+    int listen_fd_arg = -1;
+    gboolean forward_update = FALSE; // --set/--inc/--dec for the running instance
+    
     // Parse command line arguments for color
     int i = 1;
     while (i < argc) {
         if (strcmp(argv[i], "--color") == 0 || strcmp(argv[i], "--line-color") == 0) {
             if (i + 1 < argc) {
                 parse_hex_color(argv[i + 1]);
+                cli_fields |= CONFIG_COLOR;
                 // Remove both the option and its value from argv
                 remove_arguments(&argc, &argv, i, 2);
                 // Don't increment i since we removed 2 elements
@@ -472,6 +957,7 @@ int main(int argc, char **argv) {
                     *comma = '\0';
                     window_x = atoi(pos_str);
                     window_y = atoi(comma + 1);
+                    cli_fields |= CONFIG_POSITION;
                     // Remove both the option and its value from argv
                     remove_arguments(&argc, &argv, i, 2);
                     // Don't increment i since we removed 2 elements
@@ -491,6 +977,7 @@ int main(int argc, char **argv) {
             if (i + 1 < argc) {
                 if (strcmp(argv[i + 1], "vertical") == 0 || strcmp(argv[i + 1], "horizontal") == 0) {
                     orientation = argv[i + 1];
+                    cli_fields |= CONFIG_ORIENTATION;
                     // Remove both the option and its value from argv
                     remove_arguments(&argc, &argv, i, 2);
                     // Don't increment i since we removed 2 elements
@@ -504,8 +991,191 @@ int main(int argc, char **argv) {
                 printf("Usage: %s --orientation vertical|horizontal\n", argv[0]);
                 return 1;
             }
+        } else if (strcmp(argv[i], "--source-cmd") == 0 || strcmp(argv[i], "--source-file") == 0) {
+            if (i + 1 < argc) {
+                SourceKind kind = strcmp(argv[i], "--source-cmd") == 0 ? SOURCE_COMMAND : SOURCE_FILE;
+                source_free(value_source);
+                value_source = source_new(kind, socket_type, argv[i + 1]);
+                remove_arguments(&argc, &argv, i, 2);
+            } else {
+                printf("❌ Error: %s requires a command or file path\n", argv[i]);
+                printf("Usage: %s --source-cmd 'COMMAND' | --source-file PATH\n", argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--source-field") == 0 || strcmp(argv[i], "--source-regex") == 0 ||
+                   strcmp(argv[i], "--source-max") == 0) {
+            if (i + 1 >= argc || value_source == NULL) {
+                printf("❌ Error: %s requires a value and must follow --source-cmd or --source-file\n", argv[i]);
+                return 1;
+            }
+            if (strcmp(argv[i], "--source-field") == 0) {
+                source_set_field(value_source, atoi(argv[i + 1]));
+            } else if (strcmp(argv[i], "--source-max") == 0) {
+                source_set_max(value_source, g_ascii_strtod(argv[i + 1], NULL));
+            } else if (!source_set_regex(value_source, argv[i + 1])) {
+                return 1;
+            }
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--no-ingest-thread") == 0) {
+            use_ingest_thread = FALSE;
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--io-uring") == 0) {
+            use_io_uring = TRUE;
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--dbus") == 0) {
+            use_dbus = TRUE;
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--client-rate") == 0) {
+            if (i + 1 >= argc || !ratelimit_parse(argv[i + 1], &client_rate, &client_burst)) {
+                printf("❌ Error: --client-rate requires RATE or RATE:BURST (messages per second, 0 = unlimited)\n");
+                return 1;
+            }
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--listen-fd") == 0) {
+            if (i + 1 >= argc || atoi(argv[i + 1]) < 0) {
+                printf("❌ Error: --listen-fd requires a file descriptor number\n");
+                printf("Usage: %s --listen-fd FD\n", argv[0]);
+                return 1;
+            }
+            listen_fd_arg = atoi(argv[i + 1]);
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--output") == 0) {
+            if (i + 1 >= argc) {
+                printf("❌ Error: --output requires an output name, index or 'all'\n");
+                printf("Usage: %s --output DP-1|0|all\n", argv[0]);
+                return 1;
+            }
+            output_name = argv[i + 1];
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--sparkline") == 0) {
+            if (i + 1 >= argc || atoi(argv[i + 1]) < 2) {
+                printf("❌ Error: --sparkline requires the number of samples to show (at least 2)\n");
+                printf("Usage: %s --sparkline %d\n", argv[0], HISTORY_DEFAULT_SAMPLES);
+                return 1;
+            }
+            history_free(history);
+            history = history_new(atoi(argv[i + 1]));
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--style") == 0) {
+            if (i + 1 >= argc || !render_parse_style(argv[i + 1], &render_style)) {
+                printf("❌ Error: --style requires bar, centered, gradient or ramp\n");
+                printf("Usage: %s --style ramp --color-stops 15:FF0000,100:00CC66\n", argv[0]);
+                return 1;
+            }
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--color-stops") == 0) {
+            if (i + 1 >= argc || !render_parse_stops(argv[i + 1], color_stops, &num_color_stops)) {
+                printf("❌ Error: --color-stops requires up to %d PCT:RRGGBB entries, comma separated\n", RENDER_MAX_STOPS);
+                printf("Usage: %s --style ramp --color-stops 15:FF0000,100:00CC66\n", argv[0]);
+                return 1;
+            }
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--segments") == 0) {
+            if (i + 1 >= argc || atoi(argv[i + 1]) < 1 || atoi(argv[i + 1]) > SEGMENTS_MAX) {
+                printf("❌ Error: --segments requires a count between 1 and %d\n", SEGMENTS_MAX);
+                printf("Usage: %s --segments 8 [--stacked] [--segment-colors FF0000,00FF00]\n", argv[0]);
+                return 1;
+            }
+            segments_free(segments);
+            segments = segments_new(atoi(argv[i + 1]), FALSE);
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--stacked") == 0) {
+            if (segments == NULL) {
+                printf("❌ Error: --stacked must follow --segments\n");
+                return 1;
+            }
+            guint count = segments_count(segments);
+            segments_free(segments);
+            segments = segments_new(count, TRUE);
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--segment-colors") == 0) {
+            if (i + 1 >= argc) {
+                printf("❌ Error: --segment-colors requires a comma separated list of colors\n");
+                return 1;
+            }
+            segment_colors = argv[i + 1];
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--shrink") == 0) {
+            shrink_to_fit = TRUE;
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--hide-after") == 0) {
+            if (i + 1 >= argc || !autohide_parse_timeout(argv[i + 1], &hide_after_ms)) {
+                printf("❌ Error: --hide-after requires a number of seconds\n");
+                printf("Usage: %s --hide-after SECONDS\n", argv[0]);
+                return 1;
+            }
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--pause-idle") == 0) {
+            if (i + 1 >= argc || !autohide_parse_timeout(argv[i + 1], &pause_idle_ms)) {
+                printf("❌ Error: --pause-idle requires a number of seconds\n");
+                printf("Usage: %s --pause-idle SECONDS\n", argv[0]);
+                return 1;
+            }
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--thickness") == 0) {
+            if (i + 1 >= argc || atoi(argv[i + 1]) <= 0) {
+                printf("❌ Error: --thickness requires a number of pixels\n");
+                printf("Usage: %s --thickness PX\n", argv[0]);
+                return 1;
+            }
+            line_thickness = atoi(argv[i + 1]);
+            cli_fields |= CONFIG_THICKNESS;
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--config") == 0) {
+            if (i + 1 >= argc) {
+                printf("❌ Error: --config requires a file path\n");
+                printf("Usage: %s --config PATH\n", argv[0]);
+                return 1;
+            }
+            config_path = g_strdup(argv[i + 1]);
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--css") == 0) {
+            if (i + 1 >= argc) {
+                printf("❌ Error: --css requires a file path\n");
+                printf("Usage: %s --css PATH\n", argv[0]);
+                return 1;
+            }
+            css_override = argv[i + 1];
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--startup-profile") == 0) {
+            startup_profile_enable();
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            trace_init();
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--log-level") == 0) {
+            LogLevel level;
+            if (i + 1 >= argc || !log_parse_level(argv[i + 1], &level)) {
+                printf("❌ Error: --log-level requires error, warn, info or debug\n");
+                printf("Usage: %s --log-level LEVEL\n", argv[0]);
+                return 1;
+            }
+            atomic_store(&log_level, level);
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--verbose") == 0 || strcmp(argv[i], "-v") == 0) {
+            atomic_store(&log_level, LOG_LEVEL_DEBUG);
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--quiet") == 0 || strcmp(argv[i], "-q") == 0) {
+            atomic_store(&log_level, LOG_LEVEL_WARN);
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--set") == 0 || strcmp(argv[i], "--inc") == 0 ||
+                   strcmp(argv[i], "--dec") == 0) {
+            // Left in argv: the primary instance applies them in on_command_line()
+            double percent;
+            if (i + 1 < argc && parse_percent(argv[i + 1], &percent)) {
+                i += 2;
+            } else if (strcmp(argv[i], "--set") == 0) {
+                printf("❌ Error: --set requires a value between 0 and 100\n");
+                printf("Usage: %s --type TYPE --set N | --inc [N] | --dec [N]\n", argv[0]);
+                return 1;
+            } else {
+                i++;
+            }
+            forward_update = TRUE;
         } else if (strcmp(argv[i], "--debug") == 0) {
             debug_mode = 1;
+            line_thickness = 10;
+            cli_fields |= CONFIG_THICKNESS;
             printf("🐞 Debug mode enabled - using black line for better visibility\n");
             remove_arguments(&argc, &argv, i, 1);
             // Don't increment i since we removed 1 element
@@ -525,6 +1195,40 @@ int main(int argc, char **argv) {
             printf("  --orientation, --orient vertical|horizontal\n");
             printf("                          Set line orientation (default: vertical)\n");
             printf("                          Example: --orientation horizontal\n");
+            printf("  --source-cmd 'COMMAND' Run COMMAND once and read values from its output lines\n");
+            printf("                          Example: --source-cmd 'my-volume-monitor --follow'\n");
+            printf("  --source-file PATH     Watch PATH with inotify and re-read it on change\n");
+            printf("                          Example: --source-file /run/user/1000/volume\n");
+            printf("  --source-field N       Take the Nth whitespace separated field of each line\n");
+            printf("  --source-regex REGEX   Take the first capture group of REGEX from each line\n");
+            printf("  --source-max N         Raw value that corresponds to 100%% (default: 100)\n");
+            printf("  --no-ingest-thread     Handle socket/stdin/source I/O on the GTK main loop\n");
+            printf("  --io-uring             Serve the socket through io_uring (falls back if unavailable)\n");
+            printf("  --dbus                 Also accept values over D-Bus (com.linestatus.Indicator)\n");
+            printf("  --client-rate N[:B]    Messages/s per socket producer, burst B (default: 500:100, 0 = off)\n");
+            printf("  --listen-fd FD         Serve updates on an inherited listening socket\n");
+            printf("                          (LISTEN_FDS socket activation is detected automatically)\n");
+            printf("  --output NAME|N|all    Show on output NAME (e.g. DP-1) or index N, or mirror on all\n");
+            printf("  --thickness PX         Line thickness in pixels (default: 4)\n");
+            printf("  --hide-after SECONDS   Unmap the line after SECONDS without updates\n");
+            printf("  --pause-idle SECONDS   Stop redrawing after SECONDS without user input\n");
+            printf("  --sparkline SAMPLES    Show the last SAMPLES values along the line (max %d)\n", HISTORY_MAX_SAMPLES);
+            printf("  --style STYLE          bar (default), centered, gradient or ramp\n");
+            printf("  --color-stops LIST     PCT:RRGGBB,... for gradient and ramp (15:FF0000,100:00CC66)\n");
+            printf("  --segments N           One line showing N values (\"cpu:40/55/12/...\")\n");
+            printf("  --stacked              Segments add up along the line instead of side by side\n");
+            printf("  --segment-colors LIST  Comma separated segment colors, repeated as needed\n");
+            printf("  --shrink               Surface only as long as the filled part, declared opaque\n");
+            printf("  --config PATH          Config file, reloaded on change and on SIGHUP\n");
+            printf("                         (default: ~/.config/linestatus/TYPE.conf or linestatus.conf)\n");
+            printf("  --css PATH             Use PATH instead of the built-in stylesheet\n");
+            printf("  --startup-profile      Print time from main() to first frame per startup phase\n");
+            printf("  --trace                Record per-update timings, dump with SIGUSR1 or 'trace'\n");
+            printf("  --log-level LEVEL      error, warn, info or debug (default: info)\n");
+            printf("  -v, --verbose          Same as --log-level debug (logs every update)\n");
+            printf("  -q, --quiet            Same as --log-level warn\n");
+            printf("  --set N                Set the running instance of TYPE to N%% and exit\n");
+            printf("  --inc [N], --dec [N]   Raise/lower the running instance by N%% (default: 5)\n");
             printf("  --debug                Enable debug mode (black line for visibility)\n");
             printf("  -h, --help             Show this help message\n");
             printf("\n");
@@ -538,41 +1242,121 @@ int main(int argc, char **argv) {
             printf("Socket communication:\n");
             printf("  echo 60 > $XDG_RUNTIME_DIR/linestatus-TYPE.sock\n");
             printf("  ./send-status --type TYPE 60\n");
+            printf("  ./sendstatus --type TYPE stats   # JSON ingest/render counters\n");
+            printf("  ./sendstatus --type TYPE trace   # Chrome trace JSON (needs --trace)\n");
+            printf("\n");
+            printf("Forwarding to the running instance (no socket tools needed):\n");
+            printf("  %s --type volume --inc 5     # e.g. bound to XF86AudioRaiseVolume\n", argv[0]);
+            printf("\n");
+            printf("Streaming from stdin (one or more values per line):\n");
+            printf("  meter | %s --type TYPE        # lines like '60' or 'TYPE:60'\n", argv[0]);
             return 0;
         } else {
             i++; // Move to next argument
         }
     }
     
-    printf("LineStatus - Wayland Status Indicator\n");
-    printf("======================================\n");
-    printf("Minimal status indicator\n");
-    if (window_x == -1) {
-        printf("Narrow line on right edge\n");
-    } else {
-        printf("Position: %d,%d\n", window_x, window_y);
-    }
-    printf("Orientation: %s\n", orientation);
-    printf("Uses Unix socket for dynamic updates\n");
-    printf("Line color: RGB(%d, %d, %d)\n", line_r, line_g, line_b);
-    printf("Socket type: %s\n", socket_type);
-    printf("Initial volume: %.0f%%\n\n", current_volume * 100);
-    fflush(stdout); // Ensure output is flushed before GTK takes over
-    
     // Create GTK application with dynamic ID based on socket type
     char app_id[64];
     snprintf(app_id, sizeof(app_id), "com.linestatus.%s", socket_type);
     GtkApplication *app = gtk_application_new(app_id, 
-                                              G_APPLICATION_DEFAULT_FLAGS);
-    // g_signal_connect(app, "command-line", G_CALLBACK(on_command_line), NULL);
+                                              G_APPLICATION_HANDLES_COMMAND_LINE);
+    g_signal_connect(app, "command-line", G_CALLBACK(on_command_line), NULL);
+    g_signal_connect(app, "startup", G_CALLBACK(on_startup), NULL);
     g_signal_connect(app, "activate", G_CALLBACK(on_activate), NULL);
+    g_signal_connect(app, "shutdown", G_CALLBACK(on_shutdown), NULL);
+    
+    // --set/--inc/--dec are forwarded to the running instance, never start a second UI
+    if (forward_update) {
+        GError *error = NULL;
+        if (!g_application_register(G_APPLICATION(app), NULL, &error) ||
+            !g_application_get_is_remote(G_APPLICATION(app))) {
+            printf("❌ No running linestatus --type %s to forward to%s%s\n", socket_type,
+                   error ? ": " : "", error ? error->message : "");
+            g_clear_error(&error);
+            g_object_unref(app);
+            source_free(value_source);
+            return 1;
+        }
+        int status = g_application_run(G_APPLICATION(app), argc, argv);
+        g_object_unref(app);
+        source_free(value_source);
+        return status;
+    }
+    
+    // Everything from here on is logged asynchronously
+    log_init();
+    
+    // Socket activation: take over a socket the service manager is already listening on
+    socket_fd = activation_listen_fd(listen_fd_arg);
+    
+    // Warm start: the first frame shows the last value, not the default
+    restore_state();
+    get_settings(&base_settings);
+    
+    // The config file goes over the snapshot (command line options still win)
+    // and is applied again in place, over the same base, whenever it changes
+    ConfigSettings file_settings;
+    if (config_path == NULL) {
+        config_path = config_default_path(socket_type);
+    }
+    if (config_load(config_path, socket_type, &file_settings)) {
+        ConfigSettings settings = base_settings;
+        config_merge(&settings, &file_settings, cli_fields);
+        set_settings(&settings);
+        save_state_look();
+    }
+    config_watch(config_path, socket_type, on_config_changed, NULL);
+    
+    // Shrinking only fits a plain bar growing from one end
+    if ((history != NULL || segments != NULL || render_style != RENDER_BAR) && shrink_to_fit) {
+        log_warn("⚠️  --shrink only works with the plain bar style, ignoring it\n");
+        shrink_to_fit = FALSE;
+    }
+    if (history != NULL && segments != NULL) {
+        log_warn("⚠️  --sparkline has no effect with --segments\n");
+        history_free(history);
+        history = NULL;
+    }
+    if (segments != NULL) {
+        for (guint i = 0; i < segments_count(segments); i++) {
+            segments_set(segments, i, current_volume); // Restored mean, until the first vector
+        }
+        apply_segment_colors();
+    }
+    if (history != NULL) {
+        history_push(history, current_volume); // Start from the restored value
+    }
+    configure_renderer();
+    
+    // The restored value is readable through "get" / "subscribe" right away
+    Update restored_update = { .value = current_volume };
+    g_strlcpy(restored_update.key, socket_type, sizeof(restored_update.key));
+    ingest_publish(&restored_update);
+    
+    log_info("LineStatus - Wayland Status Indicator\n");
+    log_info("======================================\n");
+    log_info("Minimal status indicator\n");
+    if (window_x == -1) {
+        log_info("Narrow line on right edge\n");
+    } else {
+        log_info("Position: %d,%d\n", window_x, window_y);
+    }
+    log_info("Orientation: %s\n", orientation);
+    log_info("Uses Unix socket for dynamic updates\n");
+    log_info("Line color: RGB(%d, %d, %d)\n", line_r, line_g, line_b);
+    log_info("Socket type: %s\n", socket_type);
+    log_info("Initial volume: %.0f%%\n\n", current_volume * 100);
     
     // Run the application
-    printf("🚀 Starting GTK main loop...\n");
+    log_info("🚀 Starting GTK main loop...\n");
     int status = g_application_run(G_APPLICATION(app), argc, argv);
-    printf("🏁 GTK main loop exited with status: %d\n", status);
+    log_info("🏁 GTK main loop exited with status: %d\n", status);
     
     // Cleanup
+    ingest_stop();
+    present_shutdown();
+    
     if (css_provider != NULL) {
         g_object_unref(css_provider);
     }
@@ -583,8 +1367,16 @@ int main(int argc, char **argv) {
             unlink(socket_path); // Remove the correct socket file
         }
     }
+    source_free(value_source); // Only set if activation never happened
+    config_unwatch();
+    g_free(config_path);
+    history_free(history);
+    segments_free(segments);
+    renderer_clear(&renderer);
+    state_close();
     g_object_unref(app);
     
-    printf("👋 LineStatus Static Volume terminated\n");
+    log_info("👋 LineStatus Static Volume terminated\n");
+    log_shutdown();
     return status;
 }
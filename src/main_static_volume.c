@@ -1,18 +1,37 @@
+#define _GNU_SOURCE
 #include <gtk/gtk.h>
 #include <gtk-layer-shell/gtk-layer-shell.h>
 #include <cairo.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <glib.h>
+#include <glib-unix.h>
 #include <unistd.h>
 #include <fcntl.h>
-#include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <signal.h>
 #include <string.h>
 
+#include "ingest.h"
+#include "activation.h"
+#include "activity.h"
+#include "autohide.h"
+#include "css.h"
+#include "log.h"
+#include "output.h"
+#include "ratelimit.h"
+#include "present.h"
+#include "source.h"
+#include "startup.h"
+#include "state.h"
+#include "stats.h"
+#include "trace.h"
+
+#define BAR_THICKNESS 4 // Pixels per bar across the edge
+
 // Display element structure
 typedef struct {
     const char *name;       // Identifier ("volume", "brightness", etc.)
@@ -23,22 +42,59 @@ typedef struct {
     float r, g, b;          // Color
     GtkWidget *window;      // GTK window for this element
     GtkWidget *drawing_area; // Drawing area for this element
+    gint64 undrawn_received; // Receive time of the latest value not drawn yet
+    gint64 undrawn_sent;    // Sender timestamp of that value, 0 if not given
+    uint32_t undrawn_trace_id; // Trace id of that value, 0 when not traced
+    StateEntry *state;      // Warm-start snapshot of this element, may be NULL
+    AutoHide hide;          // Unmapped after inactivity (--hide-after)
+    gboolean suppressed;    // Value changed while rendering was paused
 } DisplayElement;
 
+// Layer surface shared by all bars along one screen edge
+typedef struct {
+    gboolean vertical;      // Vertical bars on the right edge, else horizontal bars on the bottom edge
+    int count;              // Bars drawn side by side in it
+    GtkWidget *window;
+    GtkWidget *drawing_area;
+} EdgeSurface;
+
 // Global variables
 static DisplayElement *elements = NULL;
 static int num_elements = 0;
+static EdgeSurface edge_surfaces[2]; // [0] horizontal bars, [1] vertical bars
+static gboolean surface_per_element = FALSE; // --surface-per-element: one window per bar
 static int socket_fd = -1; // Socket file descriptor
+static gboolean socket_inherited = FALSE; // Socket activation: not ours to unlink
+static GPtrArray *sources = NULL; // Native value sources (StatusSource *)
+static GtkCssProvider *css_provider = NULL;
+static const char *css_override = NULL; // --css PATH instead of the embedded stylesheet
+static gboolean use_ingest_thread = TRUE; // Socket/stdin/source I/O off the GTK thread
+static gboolean use_io_uring = FALSE; // Optional io_uring socket backend
+static gboolean use_dbus = FALSE; // --dbus: export com.linestatus.Indicator on the session bus
+static double client_rate = RATELIMIT_DEFAULT_RATE; // --client-rate: messages/s per socket producer
+static double client_burst = RATELIMIT_DEFAULT_BURST;
+static guint hide_after_ms = 0; // --hide-after SECONDS for every element, 0 = never
+static GHashTable *hide_after_by_name = NULL; // --hide-after NAME=SECONDS overrides (name -> ms)
+static guint pause_idle_ms = 0; // --pause-idle SECONDS, 0 = pause only while outputs are off
 
-// Screen dimensions
-static int screen_width = 1920;
-static int screen_height = 1080;
+// Latency and presentation bookkeeping for an element whose new value is being drawn
+static void element_drawn(DisplayElement *element, GtkWidget *widget) {
+    if (element->undrawn_received != 0) {
+        stats_record_latency(element->undrawn_received);
+        present_track(widget, element->name, element->undrawn_received,
+                      element->undrawn_sent, element->undrawn_trace_id);
+        element->undrawn_received = 0;
+        element->undrawn_sent = 0;
+    }
+}
 
 // Drawing function for individual display element
 static void on_draw_element(GtkDrawingArea *drawing_area, cairo_t *cr, int width, int height, gpointer data) {
-    (void)drawing_area;
     DisplayElement *element = (DisplayElement *)data;
     
+    stats_inc(&stats.frames_drawn);
+    element_drawn(element, GTK_WIDGET(drawing_area));
+    
     // Clear with transparent background
     cairo_set_source_rgba(cr, 0, 0, 0, 0);
     cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
@@ -63,6 +119,96 @@ static void on_draw_element(GtkDrawingArea *drawing_area, cairo_t *cr, int width
         cairo_line_to(cr, bar_width, height / 2);
     }
     cairo_stroke(cr);
+    
+    trace_event(TRACE_DRAW_END, element->undrawn_trace_id, element->name);
+    element->undrawn_trace_id = 0;
+    startup_first_frame();
+}
+
+// Drawing function for all bars of one edge: a single pass, a single commit.
+// The first bar sits on the screen edge, the others follow inwards.
+static void on_draw_edge(GtkDrawingArea *drawing_area, cairo_t *cr, int width, int height, gpointer data) {
+    EdgeSurface *surface = (EdgeSurface *)data;
+    int slot = 0;
+    
+    stats_inc(&stats.frames_drawn);
+    
+    // Clear with transparent background
+    cairo_set_source_rgba(cr, 0, 0, 0, 0);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    
+    for (int i = 0; i < num_elements; i++) {
+        DisplayElement *element = &elements[i];
+        if (element->vertical != surface->vertical) {
+            continue;
+        }
+        if (element->hide.hidden) {
+            slot++; // Keep its place so the other bars do not move
+            continue;
+        }
+        element_drawn(element, GTK_WIDGET(drawing_area));
+        
+        cairo_set_source_rgb(cr, element->r, element->g, element->b);
+        if (surface->vertical) {
+            // Vertical bar - grows from the bottom
+            int bar_height = (int)(height * element->value);
+            cairo_rectangle(cr, width - (slot + 1) * BAR_THICKNESS, height - bar_height, BAR_THICKNESS, bar_height);
+        } else {
+            // Horizontal bar - grows from the left
+            int bar_width = (int)(width * element->value);
+            cairo_rectangle(cr, 0, height - (slot + 1) * BAR_THICKNESS, bar_width, BAR_THICKNESS);
+        }
+        cairo_fill(cr);
+        slot++;
+        
+        trace_event(TRACE_DRAW_END, element->undrawn_trace_id, element->name);
+        element->undrawn_trace_id = 0;
+    }
+    startup_first_frame();
+}
+
+// Frame clock tick that is about to paint the element's pending value (tracing only)
+static void on_before_paint(GdkFrameClock *clock, gpointer data) {
+    DisplayElement *element = (DisplayElement *)data;
+    if (element->undrawn_trace_id != 0) {
+        trace_event_at(TRACE_FRAME_TICK, element->undrawn_trace_id, element->name,
+                       gdk_frame_clock_get_frame_time(clock));
+    }
+}
+
+static void on_drawing_area_realize(GtkWidget *widget, gpointer data) {
+    g_signal_connect(gtk_widget_get_frame_clock(widget), "before-paint", G_CALLBACK(on_before_paint), data);
+}
+
+// Same for every bar of an edge surface
+static void on_before_paint_edge(GdkFrameClock *clock, gpointer data) {
+    EdgeSurface *surface = (EdgeSurface *)data;
+    for (int i = 0; i < num_elements; i++) {
+        if (elements[i].vertical == surface->vertical) {
+            on_before_paint(clock, &elements[i]);
+        }
+    }
+}
+
+static void on_edge_realize(GtkWidget *widget, gpointer data) {
+    g_signal_connect(gtk_widget_get_frame_clock(widget), "before-paint", G_CALLBACK(on_before_paint_edge), data);
+}
+
+// Bars only display; an empty input region passes every click through to what is below
+static void on_window_realize(GtkWidget *widget, gpointer data) {
+    (void)data;
+    cairo_region_t *region = cairo_region_create();
+    gdk_surface_set_input_region(gtk_native_get_surface(GTK_NATIVE(widget)), region);
+    cairo_region_destroy(region);
+}
+
+// SIGUSR1: dump the trace ring (runs on the main loop, not in signal context)
+static gboolean on_trace_signal(gpointer data) {
+    (void)data;
+    g_free(trace_dump());
+    return G_SOURCE_CONTINUE;
 }
 
 // Function to find display element by name
@@ -76,77 +222,197 @@ static DisplayElement* find_element(const char *name) {
 }
 
 // Function to update display element value
-static void update_element_value(const char *name, float value) {
+static void update_element_value(const char *name, float value, gint64 received, gint64 sent, uint32_t trace_id) {
     DisplayElement *element = find_element(name);
     if (element) {
+        trace_event(TRACE_APPLY, trace_id, name);
+        trace_event(TRACE_COALESCED, element->undrawn_trace_id, name); // Replaced before it was drawn
         element->value = fmax(0.0f, fmin(1.0f, value));
-        if (element->drawing_area) {
+        state_set_value(element->state, element->value);
+        element->undrawn_received = received;
+        element->undrawn_sent = sent;
+        element->undrawn_trace_id = trace_id;
+        if (!activity_is_active()) {
+            // Nobody would see the frame: keep the value, draw it once on resume
+            element->suppressed = TRUE;
+            stats_inc(&stats.frames_suppressed);
+        } else if (element->drawing_area) {
+            autohide_touch(&element->hide);
             gtk_widget_queue_draw(element->drawing_area);
+            stats_inc(&stats.redraws_requested);
+            trace_event(TRACE_QUEUE_DRAW, trace_id, name);
         }
-        printf("📊 %s updated to: %.0f%%\n", element->name, element->value * 100);
+        log_count_update();
+        log_debug("📊 %s updated to: %.0f%%\n", element->name, element->value * 100);
     } else {
-        printf("⚠️  Unknown element: %s\n", name);
+        log_warn("⚠️  Unknown element: %s\n", name);
     }
 }
 
-// Function to create a window for a display element
-static void create_element_window(DisplayElement *element, GtkApplication *app) {
-    // Create window with appropriate size
-    int window_width, window_height;
-    if (element->vertical) {
-        window_width = 4; // 4px wide for vertical bars
-        window_height = screen_height;
+// The user came back or an output was powered on: draw what changed meanwhile
+static void on_activity_changed(gboolean active, gpointer user_data) {
+    (void)user_data;
+    for (int i = 0; i < num_elements && active; i++) {
+        DisplayElement *element = &elements[i];
+        if (!element->suppressed || element->drawing_area == NULL) {
+            continue;
+        }
+        element->suppressed = FALSE;
+        element->undrawn_received = 0; // Held back on purpose, not render latency
+        element->undrawn_sent = 0;
+        autohide_touch(&element->hide);
+        gtk_widget_queue_draw(element->drawing_area);
+        stats_inc(&stats.redraws_requested);
+    }
+}
+
+// Apply an update handed over by the ingest thread (runs on the GTK thread)
+static void apply_update(const Update *update, gpointer user_data) {
+    (void)user_data;
+    if (update->index != 0) {
+        return; // Elements here show a single value; the first entry of a vector updates it
+    }
+    update_element_value(update->key, update->value, update->received, update->sent, update->trace_id);
+}
+
+// Layer-shell window along the right (vertical) or bottom (horizontal) edge,
+// thickness pixels across
+static GtkWidget *create_edge_window(GtkApplication *app, gboolean vertical, int thickness) {
+    // Create window with appropriate size; the bars are stretched along the
+    // edge by the compositor, starting from the real output size avoids a
+    // first buffer of the wrong size
+    int window_width, window_height, output_width, output_height;
+    output_get_size(output_first(), &output_width, &output_height);
+    if (vertical) {
+        window_width = thickness;
+        window_height = output_height;
     } else {
-        window_width = screen_width;
-        window_height = 4; // 4px tall for horizontal bars
+        window_width = output_width;
+        window_height = thickness;
     }
     
-    element->window = gtk_application_window_new(app);
-    gtk_window_set_default_size(GTK_WINDOW(element->window), window_width, window_height);
-    gtk_window_set_resizable(GTK_WINDOW(element->window), FALSE);
+    GtkWidget *window = gtk_application_window_new(app);
+    gtk_window_set_default_size(GTK_WINDOW(window), window_width, window_height);
+    gtk_window_set_resizable(GTK_WINDOW(window), FALSE);
     
     // Set up layer shell for proper overlay positioning
-    gtk_layer_init_for_window(GTK_WINDOW(element->window));
-    gtk_layer_set_layer(GTK_WINDOW(element->window), GTK_LAYER_SHELL_LAYER_OVERLAY);
+    gtk_layer_init_for_window(GTK_WINDOW(window));
+    gtk_layer_set_layer(GTK_WINDOW(window), GTK_LAYER_SHELL_LAYER_OVERLAY);
     
     // Position the window
-    if (element->vertical) {
+    if (vertical) {
         // Vertical bar - anchor to right edge, no margin (exactly on edge)
-        gtk_layer_set_anchor(GTK_WINDOW(element->window), GTK_LAYER_SHELL_EDGE_RIGHT, TRUE);
-        gtk_layer_set_anchor(GTK_WINDOW(element->window), GTK_LAYER_SHELL_EDGE_TOP, TRUE);
-        gtk_layer_set_anchor(GTK_WINDOW(element->window), GTK_LAYER_SHELL_EDGE_BOTTOM, TRUE);
-        gtk_layer_set_margin(GTK_WINDOW(element->window), GTK_LAYER_SHELL_EDGE_RIGHT, 0);
+        gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_RIGHT, TRUE);
+        gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_TOP, TRUE);
+        gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_BOTTOM, TRUE);
+        gtk_layer_set_margin(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_RIGHT, 0);
     } else {
         // Horizontal bar - anchor to bottom edge, no margin (exactly on edge)
-        gtk_layer_set_anchor(GTK_WINDOW(element->window), GTK_LAYER_SHELL_EDGE_BOTTOM, TRUE);
-        gtk_layer_set_anchor(GTK_WINDOW(element->window), GTK_LAYER_SHELL_EDGE_LEFT, TRUE);
-        gtk_layer_set_anchor(GTK_WINDOW(element->window), GTK_LAYER_SHELL_EDGE_RIGHT, TRUE);
-        gtk_layer_set_margin(GTK_WINDOW(element->window), GTK_LAYER_SHELL_EDGE_BOTTOM, 0);
+        gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_BOTTOM, TRUE);
+        gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_LEFT, TRUE);
+        gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_RIGHT, TRUE);
+        gtk_layer_set_margin(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_BOTTOM, 0);
     }
     
     // No exclusive zone - don't reserve space
-    gtk_layer_set_exclusive_zone(GTK_WINDOW(element->window), -1);
+    gtk_layer_set_exclusive_zone(GTK_WINDOW(window), -1);
     
-    // Note: Window is naturally click-through due to small size
-    // Clicks will pass through to applications behind it
+    // Click-through: no input region at all
+    g_signal_connect(window, "realize", G_CALLBACK(on_window_realize), NULL);
+    return window;
+}
+
+static GtkWidget *create_drawing_area(GtkDrawingAreaDrawFunc draw, gpointer data) {
+    GtkWidget *drawing_area = gtk_drawing_area_new();
+    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(drawing_area), draw, data, NULL);
+    gtk_widget_set_hexpand(drawing_area, TRUE);
+    gtk_widget_set_vexpand(drawing_area, TRUE);
+    return drawing_area;
+}
+
+// Function to create a window for a display element (--surface-per-element)
+static void create_element_window(DisplayElement *element, GtkApplication *app) {
+    element->window = create_edge_window(app, element->vertical, BAR_THICKNESS);
     
     // Create drawing area
-    element->drawing_area = gtk_drawing_area_new();
-    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(element->drawing_area), on_draw_element, element, NULL);
-    gtk_widget_set_hexpand(element->drawing_area, TRUE);
-    gtk_widget_set_vexpand(element->drawing_area, TRUE);
+    element->drawing_area = create_drawing_area(on_draw_element, element);
+    if (trace_enabled) {
+        g_signal_connect(element->drawing_area, "realize", G_CALLBACK(on_drawing_area_realize), element);
+    }
     
     // Set window child and show
     gtk_window_set_child(GTK_WINDOW(element->window), element->drawing_area);
     gtk_window_present(GTK_WINDOW(element->window));
 }
 
+// One window per edge hosting all bars of that orientation, so surfaces,
+// buffers and commits do not grow with the number of elements
+static void create_edge_surfaces(GtkApplication *app) {
+    for (int v = 0; v < 2; v++) {
+        EdgeSurface *surface = &edge_surfaces[v];
+        surface->vertical = v;
+        surface->count = 0;
+        for (int i = 0; i < num_elements; i++) {
+            surface->count += elements[i].vertical == surface->vertical;
+        }
+        if (surface->count == 0) {
+            continue;
+        }
+        
+        surface->window = create_edge_window(app, surface->vertical, surface->count * BAR_THICKNESS);
+        surface->drawing_area = create_drawing_area(on_draw_edge, surface);
+        if (trace_enabled) {
+            g_signal_connect(surface->drawing_area, "realize", G_CALLBACK(on_edge_realize), surface);
+        }
+        gtk_window_set_child(GTK_WINDOW(surface->window), surface->drawing_area);
+        
+        // Updates of any of its elements redraw the shared area
+        for (int i = 0; i < num_elements; i++) {
+            if (elements[i].vertical == surface->vertical) {
+                elements[i].window = surface->window;
+                elements[i].drawing_area = surface->drawing_area;
+            }
+        }
+        gtk_window_present(GTK_WINDOW(surface->window));
+        log_info("🪟 %s edge surface with %d bar(s)\n", surface->vertical ? "Right" : "Bottom", surface->count);
+    }
+}
+
+// Timeout of one element: its own --hide-after NAME=SECONDS, else the global one
+static guint element_hide_after(const char *name) {
+    gpointer ms;
+    if (hide_after_by_name != NULL && g_hash_table_lookup_extended(hide_after_by_name, name, NULL, &ms)) {
+        return GPOINTER_TO_UINT(ms);
+    }
+    return hide_after_ms;
+}
+
+// An element went idle or got a new value. Its own window is simply unmapped;
+// a shared edge surface stays mapped as long as one of its bars is shown.
+static void on_element_autohide(gboolean visible, gpointer user_data) {
+    DisplayElement *element = user_data;
+    gboolean mapped = FALSE;
+    
+    log_debug(visible ? "👀 %s shown again\n" : "🙈 %s hidden after inactivity\n", element->name);
+    if (element->window == NULL) {
+        return;
+    }
+    if (surface_per_element) {
+        mapped = visible;
+    }
+    for (int i = 0; i < num_elements && !surface_per_element; i++) {
+        mapped |= elements[i].window == element->window && !elements[i].hide.hidden;
+    }
+    gtk_widget_set_visible(element->window, mapped);
+    gtk_widget_queue_draw(element->drawing_area);
+}
+
 // Function to add a new display element
-static void add_display_element(const char *name, float x, float y, bool vertical, float r, float g, float b, GtkApplication *app) {
+static void add_display_element(const char *name, float x, float y, bool vertical, float r, float g, float b) {
     // Reallocate elements array
     DisplayElement *new_elements = realloc(elements, (num_elements + 1) * sizeof(DisplayElement));
     if (!new_elements) {
-        printf("⚠️  Failed to allocate memory for new element\n");
+        log_warn("⚠️  Failed to allocate memory for new element\n");
         return;
     }
     
@@ -164,11 +430,38 @@ static void add_display_element(const char *name, float x, float y, bool vertica
     element->b = b;
     element->window = NULL;
     element->drawing_area = NULL;
+    element->undrawn_received = 0;
+    element->undrawn_sent = 0;
+    element->undrawn_trace_id = 0;
+    element->suppressed = FALSE;
+    
+    // Warm start: take the last value, color and geometry over from the previous run
+    gboolean restored;
+    element->state = state_entry(name, &restored);
+    if (restored) {
+        element->value = element->state->value;
+        element->x_pos = element->state->x;
+        element->y_pos = element->state->y;
+        element->vertical = element->state->vertical;
+        element->r = element->state->r;
+        element->g = element->state->g;
+        element->b = element->state->b;
+    } else if (element->state != NULL) {
+        element->state->value = element->value;
+        element->state->x = element->x_pos;
+        element->state->y = element->y_pos;
+        element->state->vertical = element->vertical;
+        element->state->r = element->r;
+        element->state->g = element->g;
+        element->state->b = element->b;
+    }
     
-    // Create window for this element
-    create_element_window(element, app);
+    // Readable through "get" / "subscribe" before the first update arrives
+    Update initial = { .value = element->value };
+    g_strlcpy(initial.key, element->name, sizeof(initial.key));
+    ingest_publish(&initial);
     
-    printf("➕ Added %s display at (%.1f, %.1f) - %.1f%%\n", 
+    log_info("➕ Added %s display at (%.1f, %.1f) - %.1f%%\n", 
            element->name, element->x_pos * 100, element->y_pos * 100, element->value * 100);
 }
 
@@ -199,8 +492,8 @@ static int create_socket(const char *socket_path) {
         return -1;
     }
     
-    // Listen for connections
-    if (listen(fd, 5) < 0) {
+    // Listen for connections - a deep backlog absorbs bursts of one-shot senders
+    if (listen(fd, SOMAXCONN) < 0) {
         perror("listen");
         close(fd);
         return -1;
@@ -212,193 +505,336 @@ static int create_socket(const char *socket_path) {
     return fd;
 }
 
-// Function to handle socket connections
-static gboolean handle_socket(gpointer user_data) {
-    (void)user_data;
-    
-    if (socket_fd < 0) {
-        return G_SOURCE_CONTINUE;
-    }
-    
-    // Check if there's a connection
-    fd_set read_fds;
-    FD_ZERO(&read_fds);
-    FD_SET(socket_fd, &read_fds);
-    
-    struct timeval timeout = {0, 0}; // Non-blocking check
-    if (select(socket_fd + 1, &read_fds, NULL, NULL, &timeout) > 0) {
-        if (FD_ISSET(socket_fd, &read_fds)) {
-            // Accept connection
-            struct sockaddr_un client_addr;
-            socklen_t client_len = sizeof(client_addr);
-            int client_fd = accept(socket_fd, (struct sockaddr *)&client_addr, &client_len);
-            
-            if (client_fd >= 0) {
-                // Read data from client
-                char buffer[32];
-                ssize_t bytes_read = read(client_fd, buffer, sizeof(buffer) - 1);
-                
-                if (bytes_read > 0) {
-                    buffer[bytes_read] = '\0';
-                    
-                    // Parse the value - support both simple numbers and key:value format
-                    char *endptr;
-                    long value_percent = strtol(buffer, &endptr, 10);
-                    
-                    if (endptr != buffer) {
-                        // Simple number format (backward compatible)
-                        if (value_percent >= 0 && value_percent <= 100) {
-                            update_element_value("volume", value_percent / 100.0f);
-                        } else {
-                            printf("⚠️  Invalid volume value: %s", buffer);
-                        }
-                    } else if (strstr(buffer, ":") != NULL) {
-                        // Key:value format
-                        char *colon = strchr(buffer, ':');
-                        if (colon) {
-                            *colon = '\0';
-                            char *key = buffer;
-                            char *value_str = colon + 1;
-                            
-                            long value = strtol(value_str, &endptr, 10);
-                            if (endptr != value_str && value >= 0 && value <= 100) {
-                                if (strcmp(key, "volume") == 0) {
-                                    update_element_value("volume", value / 100.0f);
-                                } else if (strcmp(key, "brightness") == 0) {
-                                    update_element_value("brightness", value / 100.0f);
-                                } else {
-                                    printf("📭 Unknown key received: %s=%ld\n", key, value);
-                                }
-                            } else {
-                                printf("⚠️  Invalid value for key %s: %s", key, value_str);
-                            }
-                        }
-                    } else {
-                        printf("⚠️  Invalid format: %s", buffer);
-                    }
-                }
-                
-                close(client_fd);
-            }
-        }
-    }
-    
-    return G_SOURCE_CONTINUE; // Keep checking
+// GTK is initialized and the application registered
+static void on_startup(GtkApplication *app, gpointer user_data) {
+    (void)app; (void)user_data;
+    startup_mark("gtk_init");
 }
 
-// Function to read volume from stdin using timeout
-static gboolean check_stdin(gpointer user_data) {
+static void on_activate(GtkApplication *app, gpointer user_data) {
     (void)user_data;
     
-    // Check if there's data available on stdin
-    fd_set read_fds;
-    FD_ZERO(&read_fds);
-    FD_SET(STDIN_FILENO, &read_fds);
-    
-    struct timeval timeout = {0, 0}; // Non-blocking check
-    if (select(STDIN_FILENO + 1, &read_fds, NULL, NULL, &timeout) > 0) {
-        if (FD_ISSET(STDIN_FILENO, &read_fds)) {
-            char buffer[32];
-            if (fgets(buffer, sizeof(buffer), stdin) != NULL) {
-                // Parse the volume value
-                char *endptr;
-                long volume_percent = strtol(buffer, &endptr, 10);
-                
-                if (endptr != buffer && volume_percent >= 0 && volume_percent <= 100) {
-                    update_element_value("volume", volume_percent / 100.0f);
-                } else {
-                    printf("⚠️  Invalid volume value: %s", buffer);
-                }
+    // A second plain launch only activates the primary again: &elements[i] is
+    // held by windows and timers, so the array must not grow; leave
+    // auto-hidden bars alone
+    if (elements != NULL) {
+        for (int i = 0; i < num_elements; i++) {
+            if (elements[i].window != NULL && gtk_widget_get_visible(elements[i].window)) {
+                gtk_window_present(GTK_WINDOW(elements[i].window));
             }
         }
+        return;
     }
     
-    return G_SOURCE_CONTINUE; // Keep the timeout running
-}
-
-
-
-// Activate function - creates display element windows
-static void on_activate(GtkApplication *app, gpointer user_data) {
-    (void)user_data;
+    // Transparent windows (embedded stylesheet unless overridden with --css)
+    css_provider = css_install(css_override);
+    startup_mark("css");
     
     // Initialize display elements - exactly on screen edges
-    add_display_element("volume", 1.0f, 0.0f, true, 1.0f, 0.647f, 0.0f, app); // Orange, right edge, vertical
-    add_display_element("brightness", 0.0f, 1.0f, false, 0.0f, 0.8f, 1.0f, app); // Blue, bottom edge, horizontal
+    add_display_element("volume", 1.0f, 0.0f, true, 1.0f, 0.647f, 0.0f); // Orange, right edge, vertical
+    add_display_element("brightness", 0.0f, 1.0f, false, 0.0f, 0.8f, 1.0f); // Blue, bottom edge, horizontal
+    
+    // Windows, draw callbacks and timers get &elements[i]: only once the array no longer moves
+    if (!surface_per_element) {
+        create_edge_surfaces(app);
+    }
+    for (int i = 0; i < num_elements; i++) {
+        if (surface_per_element) {
+            create_element_window(&elements[i], app);
+        }
+        autohide_init(&elements[i].hide, element_hide_after(elements[i].name), on_element_autohide, &elements[i]);
+    }
+    activity_watch(pause_idle_ms, on_activity_changed, NULL);
+    startup_mark("layer_shell");
     
     // Create Unix domain socket for volume updates
+    IngestConfig ingest = {
+        .listen_fd = -1,
+        .watch_stdin = FALSE,
+        .sources = sources, // Native sources start now that their elements exist
+        .default_key = "volume",
+        .threaded = use_ingest_thread,
+        .io_uring = use_io_uring,
+        .client_rate = client_rate,
+        .client_burst = client_burst,
+        .bus = NULL,
+        .bus_path = NULL,
+        .apply = apply_update,
+        .applied = NULL,
+        .user_data = NULL,
+    };
+    
+    // Same ingest path as the socket, on the bus name the application already owns
+    if (use_dbus) {
+        ingest.bus = g_application_get_dbus_connection(G_APPLICATION(app));
+        ingest.bus_path = g_application_get_dbus_object_path(G_APPLICATION(app));
+        if (ingest.bus == NULL) {
+            log_warn("⚠️  No session bus, D-Bus interface disabled\n");
+        }
+    }
+    sources = NULL; // Owned by ingest from here on
+    
     const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
-    if (runtime_dir) {
+    if (socket_inherited) {
+        ingest.listen_fd = socket_fd;
+    } else if (runtime_dir) {
         char socket_path[256];
         snprintf(socket_path, sizeof(socket_path), "%s/linestatus.sock", runtime_dir);
         
         socket_fd = create_socket(socket_path);
         if (socket_fd >= 0) {
-            printf("🔌 Socket created at: %s\n", socket_path);
-            g_timeout_add(100, handle_socket, NULL);
+            log_info("🔌 Socket created at: %s\n", socket_path);
+            ingest.listen_fd = socket_fd;
         } else {
-            printf("⚠️  Failed to create socket, falling back to stdin\n");
-            g_timeout_add(100, check_stdin, NULL);
+            log_warn("⚠️  Failed to create socket, falling back to stdin\n");
+            ingest.watch_stdin = TRUE;
         }
     } else {
-        printf("⚠️  XDG_RUNTIME_DIR not set, using stdin\n");
-        g_timeout_add(100, check_stdin, NULL);
+        log_warn("⚠️  XDG_RUNTIME_DIR not set, using stdin\n");
+        ingest.watch_stdin = TRUE;
+    }
+    
+    // A pipe on stdin (meter | linestatus) streams alongside the socket
+    struct stat stdin_stat;
+    if (ingest.listen_fd >= 0 && fstat(STDIN_FILENO, &stdin_stat) == 0 &&
+        (S_ISFIFO(stdin_stat.st_mode) || S_ISSOCK(stdin_stat.st_mode))) {
+        log_info("🔌 Also reading updates from stdin\n");
+        ingest.watch_stdin = TRUE;
     }
     
-    printf("✅ LineStatus Multi Display started\n");
-    printf("🪟 Separate narrow windows for each indicator\n");
-    printf("📊 Displaying %d elements\n", num_elements);
-    printf("🖱️  Clicks pass through - no interference\n");
-    printf("📭  Send updates: ./send-volume 60\n");
-    printf("📭  Send updates: ./send-volume 80 brightness\n");
+    if (trace_enabled) {
+        g_unix_signal_add(SIGUSR1, on_trace_signal, NULL);
+    }
+    
+    if (!ingest_start(&ingest)) {
+        log_warn("⚠️  Failed to start ingest thread\n");
+    }
+    startup_mark("socket");
+    
+    log_info("✅ LineStatus Multi Display started\n");
+    log_info(surface_per_element ? "🪟 Separate narrow windows for each indicator\n"
+                                  : "🪟 One shared surface per screen edge\n");
+    log_info("📊 Displaying %d elements\n", num_elements);
+    log_info("🖱️  Clicks pass through - no interference\n");
+    log_info("📭  Send updates: ./send-volume 60\n");
+    log_info("📭  Send updates: ./send-volume 80 brightness\n");
+}
+
+// Function to remove processed arguments from argv
+static void remove_arguments(int *argc, char ***argv, int start_index, int count) {
+    for (int i = start_index; i < *argc - count; i++) {
+        (*argv)[i] = (*argv)[i + count];
+    }
+    *argc -= count;
+}
+
+// Parse "NAME=TARGET" for --source-cmd / --source-file
+static StatusSource *parse_source_arg(SourceKind kind, const char *arg) {
+    const char *equals = strchr(arg, '=');
+    if (equals == NULL || equals == arg || equals[1] == '\0') {
+        return NULL;
+    }
+    
+    char *name = g_strndup(arg, equals - arg);
+    StatusSource *src = source_new(kind, name, equals + 1);
+    g_free(name);
+    return src;
 }
 
 int main(int argc, char **argv) {
     // Volume updates come from stdin, not command line arguments
     // This allows for simple piping: echo 60 | ./linestatus-static-volume
+    int listen_fd_arg = -1;
+    
+    // Parse native source declarations; modifiers apply to the latest source
+    StatusSource *last_source = NULL;
+    int i = 1;
+    while (i < argc) {
+        if (strcmp(argv[i], "--source-cmd") == 0 || strcmp(argv[i], "--source-file") == 0) {
+            SourceKind kind = strcmp(argv[i], "--source-cmd") == 0 ? SOURCE_COMMAND : SOURCE_FILE;
+            last_source = i + 1 < argc ? parse_source_arg(kind, argv[i + 1]) : NULL;
+            if (last_source == NULL) {
+                printf("❌ Error: %s requires NAME=TARGET\n", argv[i]);
+                printf("Example: %s --source-cmd 'volume=my-volume-monitor --follow'\n", argv[0]);
+                printf("         %s --source-file brightness=/sys/class/backlight/intel_backlight/brightness\n", argv[0]);
+                return 1;
+            }
+            if (sources == NULL) {
+                sources = g_ptr_array_new_with_free_func((GDestroyNotify)source_free);
+            }
+            g_ptr_array_add(sources, last_source);
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--source-field") == 0 || strcmp(argv[i], "--source-regex") == 0 ||
+                   strcmp(argv[i], "--source-max") == 0) {
+            if (i + 1 >= argc || last_source == NULL) {
+                printf("❌ Error: %s requires a value and must follow --source-cmd or --source-file\n", argv[i]);
+                return 1;
+            }
+            if (strcmp(argv[i], "--source-field") == 0) {
+                source_set_field(last_source, atoi(argv[i + 1]));
+            } else if (strcmp(argv[i], "--source-max") == 0) {
+                source_set_max(last_source, g_ascii_strtod(argv[i + 1], NULL));
+            } else if (!source_set_regex(last_source, argv[i + 1])) {
+                return 1;
+            }
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--no-ingest-thread") == 0) {
+            use_ingest_thread = FALSE;
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--io-uring") == 0) {
+            use_io_uring = TRUE;
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--dbus") == 0) {
+            use_dbus = TRUE;
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--client-rate") == 0) {
+            if (i + 1 >= argc || !ratelimit_parse(argv[i + 1], &client_rate, &client_burst)) {
+                printf("❌ Error: --client-rate requires RATE or RATE:BURST (messages per second, 0 = unlimited)\n");
+                return 1;
+            }
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--listen-fd") == 0) {
+            if (i + 1 >= argc || atoi(argv[i + 1]) < 0) {
+                printf("❌ Error: --listen-fd requires a file descriptor number\n");
+                return 1;
+            }
+            listen_fd_arg = atoi(argv[i + 1]);
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--hide-after") == 0) {
+            // SECONDS for all elements or NAME=SECONDS for one
+            const char *equals = i + 1 < argc ? strchr(argv[i + 1], '=') : NULL;
+            guint ms;
+            if (i + 1 >= argc || !autohide_parse_timeout(equals != NULL ? equals + 1 : argv[i + 1], &ms)) {
+                printf("❌ Error: --hide-after requires SECONDS or NAME=SECONDS\n");
+                return 1;
+            }
+            if (equals == NULL) {
+                hide_after_ms = ms;
+            } else {
+                if (hide_after_by_name == NULL) {
+                    hide_after_by_name = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+                }
+                g_hash_table_insert(hide_after_by_name, g_strndup(argv[i + 1], equals - argv[i + 1]), GUINT_TO_POINTER(ms));
+            }
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--pause-idle") == 0) {
+            if (i + 1 >= argc || !autohide_parse_timeout(argv[i + 1], &pause_idle_ms)) {
+                printf("❌ Error: --pause-idle requires a number of seconds\n");
+                return 1;
+            }
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--surface-per-element") == 0) {
+            surface_per_element = TRUE;
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--css") == 0) {
+            if (i + 1 >= argc) {
+                printf("❌ Error: --css requires a file path\n");
+                return 1;
+            }
+            css_override = argv[i + 1];
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--startup-profile") == 0) {
+            startup_profile_enable();
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            trace_init();
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--log-level") == 0) {
+            LogLevel level;
+            if (i + 1 >= argc || !log_parse_level(argv[i + 1], &level)) {
+                printf("❌ Error: --log-level requires error, warn, info or debug\n");
+                return 1;
+            }
+            atomic_store(&log_level, level);
+            remove_arguments(&argc, &argv, i, 2);
+        } else if (strcmp(argv[i], "--verbose") == 0 || strcmp(argv[i], "-v") == 0) {
+            atomic_store(&log_level, LOG_LEVEL_DEBUG);
+            remove_arguments(&argc, &argv, i, 1);
+        } else if (strcmp(argv[i], "--quiet") == 0 || strcmp(argv[i], "-q") == 0) {
+            atomic_store(&log_level, LOG_LEVEL_WARN);
+            remove_arguments(&argc, &argv, i, 1);
+        } else {
+            i++; // Move to next argument
+        }
+    }
+    
+    // Everything from here on is logged asynchronously
+    log_init();
+    
+    // Socket activation: take over a socket the service manager is already listening on
+    socket_fd = activation_listen_fd(listen_fd_arg);
+    socket_inherited = socket_fd >= 0;
     
-    printf("LineStatus - Multi Display\n");
-    printf("==========================\n");
-    printf("Modular display system\n");
-    printf("Supports multiple indicators\n");
-    printf("Uses Unix socket for updates\n");
-    printf("Initializing...\n\n");
+    // Warm-start snapshot shared by all elements (restored in add_display_element)
+    state_open("static");
+    
+    log_info("LineStatus - Multi Display\n");
+    log_info("==========================\n");
+    log_info("Modular display system\n");
+    log_info("Supports multiple indicators\n");
+    log_info("Uses Unix socket for updates\n");
+    log_info("Initializing...\n\n");
     
     // Create GTK application
     GtkApplication *app = gtk_application_new("com.linestatus.staticvolume", 
                                               G_APPLICATION_DEFAULT_FLAGS);
     // g_signal_connect(app, "command-line", G_CALLBACK(on_command_line), NULL);
+    g_signal_connect(app, "startup", G_CALLBACK(on_startup), NULL);
     g_signal_connect(app, "activate", G_CALLBACK(on_activate), NULL);
     
     // Run the application
-    printf("🚀 Starting GTK main loop...\n");
+    log_info("🚀 Starting GTK main loop...\n");
     int status = g_application_run(G_APPLICATION(app), argc, argv);
-    printf("🏁 GTK main loop exited with status: %d\n", status);
+    log_info("🏁 GTK main loop exited with status: %d\n", status);
     
     // Cleanup
+    ingest_stop();
+    present_shutdown();
+    
     if (socket_fd >= 0) {
         close(socket_fd);
         const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
-        if (runtime_dir) {
+        if (runtime_dir && !socket_inherited) {
             char socket_path[256];
             snprintf(socket_path, sizeof(socket_path), "%s/linestatus.sock", runtime_dir);
             unlink(socket_path); // Remove socket file
         }
     }
     
-    // Destroy display element windows
+    // Destroy display element windows; elements on an edge surface only
+    // borrow its window, which is destroyed once
+    activity_unwatch();
     if (elements) {
         for (int i = 0; i < num_elements; i++) {
-            if (elements[i].window) {
+            autohide_clear(&elements[i].hide);
+            if (surface_per_element && elements[i].window) {
                 gtk_window_destroy(GTK_WINDOW(elements[i].window));
             }
             g_free((void *)elements[i].name);
         }
         free(elements);
     }
+    for (int v = 0; v < 2; v++) {
+        if (edge_surfaces[v].window) {
+            gtk_window_destroy(GTK_WINDOW(edge_surfaces[v].window));
+            edge_surfaces[v].window = NULL;
+        }
+    }
     
+    if (sources) {
+        g_ptr_array_free(sources, TRUE); // Only set if activation never happened
+    }
+    
+    if (hide_after_by_name != NULL) {
+        g_hash_table_destroy(hide_after_by_name);
+    }
+    if (css_provider != NULL) {
+        g_object_unref(css_provider);
+    }
+    state_close();
     g_object_unref(app);
     
-    printf("👋 LineStatus Static Volume terminated\n");
+    log_info("👋 LineStatus Static Volume terminated\n");
+    log_shutdown();
     return status;
 }
\ No newline at end of file
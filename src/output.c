@@ -0,0 +1,183 @@
+#include "output.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+
+static OutputsChangedFunc changed_func = NULL;
+static gpointer changed_data = NULL;
+static GListModel *watched_list = NULL;
+static GPtrArray *watched_monitors = NULL; // GdkMonitor * with our notify handlers
+static guint changed_idle = 0;
+
+static GListModel *output_list(void) {
+    GdkDisplay *display = gdk_display_get_default();
+    return display != NULL ? gdk_display_get_monitors(display) : NULL;
+}
+
+GdkMonitor *output_find(const char *name) {
+    GListModel *monitors = output_list();
+    char *end = NULL;
+    
+    if (monitors == NULL || name == NULL) {
+        return NULL;
+    }
+    
+    // A plain number is an index
+    long index = strtol(name, &end, 10);
+    if (end != name && *end == '\0') {
+        if (index < 0 || (guint)index >= g_list_model_get_n_items(monitors)) {
+            return NULL;
+        }
+        GdkMonitor *monitor = g_list_model_get_item(monitors, index);
+        g_object_unref(monitor); // The list keeps it alive
+        return monitor;
+    }
+    
+    for (guint i = 0; i < g_list_model_get_n_items(monitors); i++) {
+        GdkMonitor *monitor = g_list_model_get_item(monitors, i);
+        g_object_unref(monitor);
+        const char *connector = gdk_monitor_get_connector(monitor);
+        if (connector != NULL && strcmp(connector, name) == 0) {
+            return monitor;
+        }
+    }
+    return NULL;
+}
+
+GdkMonitor *output_first(void) {
+    GListModel *monitors = output_list();
+    
+    if (monitors == NULL || g_list_model_get_n_items(monitors) == 0) {
+        return NULL;
+    }
+    GdkMonitor *monitor = g_list_model_get_item(monitors, 0);
+    g_object_unref(monitor);
+    return monitor;
+}
+
+GdkMonitor *output_for_widget(GtkWidget *widget) {
+    GtkNative *native = widget != NULL ? gtk_widget_get_native(widget) : NULL;
+    GdkSurface *surface = native != NULL ? gtk_native_get_surface(native) : NULL;
+    
+    if (surface != NULL) {
+        GdkMonitor *monitor = gdk_display_get_monitor_at_surface(gtk_widget_get_display(widget), surface);
+        if (monitor != NULL) {
+            return monitor;
+        }
+    }
+    return output_first();
+}
+
+void output_get_size(GdkMonitor *monitor, int *width, int *height) {
+    GdkRectangle geometry;
+    
+    if (monitor == NULL) {
+        *width = OUTPUT_FALLBACK_WIDTH;
+        *height = OUTPUT_FALLBACK_HEIGHT;
+        return;
+    }
+    gdk_monitor_get_geometry(monitor, &geometry);
+    *width = geometry.width;
+    *height = geometry.height;
+}
+
+double output_get_scale(GdkMonitor *monitor) {
+    if (monitor == NULL) {
+        return 1.0;
+    }
+#if GTK_CHECK_VERSION(4, 14, 0)
+    return gdk_monitor_get_scale(monitor);
+#else
+    return gdk_monitor_get_scale_factor(monitor);
+#endif
+}
+
+const char *output_get_name(GdkMonitor *monitor) {
+    const char *connector = monitor != NULL ? gdk_monitor_get_connector(monitor) : NULL;
+    return connector != NULL ? connector : "?";
+}
+
+static gboolean output_changed_idle(gpointer data) {
+    (void)data;
+    changed_idle = 0;
+    changed_func(changed_data);
+    return G_SOURCE_REMOVE;
+}
+
+// Hotplug usually arrives as several list and property changes; handle them together
+static void output_schedule_changed(void) {
+    if (changed_idle == 0 && changed_func != NULL) {
+        changed_idle = g_idle_add(output_changed_idle, NULL);
+    }
+}
+
+static void on_monitor_notify(GObject *object, GParamSpec *pspec, gpointer data) {
+    (void)object; (void)pspec; (void)data;
+    output_schedule_changed();
+}
+
+static void output_forget_monitors(void) {
+    if (watched_monitors == NULL) {
+        return;
+    }
+    for (guint i = 0; i < watched_monitors->len; i++) {
+        GdkMonitor *monitor = g_ptr_array_index(watched_monitors, i);
+        g_signal_handlers_disconnect_by_func(monitor, on_monitor_notify, NULL);
+        g_object_unref(monitor);
+    }
+    g_ptr_array_set_size(watched_monitors, 0);
+}
+
+// Follow geometry and scale of every current output
+static void output_watch_monitors(void) {
+    output_forget_monitors();
+    for (guint i = 0; i < g_list_model_get_n_items(watched_list); i++) {
+        GdkMonitor *monitor = g_list_model_get_item(watched_list, i); // Reference kept until forgotten
+        g_signal_connect(monitor, "notify::geometry", G_CALLBACK(on_monitor_notify), NULL);
+#if GTK_CHECK_VERSION(4, 14, 0)
+        g_signal_connect(monitor, "notify::scale", G_CALLBACK(on_monitor_notify), NULL);
+#else
+        g_signal_connect(monitor, "notify::scale-factor", G_CALLBACK(on_monitor_notify), NULL);
+#endif
+        g_ptr_array_add(watched_monitors, monitor);
+    }
+}
+
+static void on_monitors_changed(GListModel *list, guint position, guint removed, guint added, gpointer data) {
+    (void)list; (void)position; (void)data;
+    log_info("🖥️  Outputs changed (%u removed, %u added)\n", removed, added);
+    output_watch_monitors();
+    output_schedule_changed();
+}
+
+void output_watch(OutputsChangedFunc func, gpointer user_data) {
+    output_unwatch();
+    watched_list = output_list();
+    if (watched_list == NULL) {
+        return;
+    }
+    changed_func = func;
+    changed_data = user_data;
+    watched_monitors = g_ptr_array_new();
+    g_signal_connect(watched_list, "items-changed", G_CALLBACK(on_monitors_changed), NULL);
+    output_watch_monitors();
+}
+
+void output_unwatch(void) {
+    if (watched_list != NULL) {
+        g_signal_handlers_disconnect_by_func(watched_list, on_monitors_changed, NULL);
+        watched_list = NULL;
+    }
+    output_forget_monitors();
+    if (watched_monitors != NULL) {
+        g_ptr_array_free(watched_monitors, TRUE);
+        watched_monitors = NULL;
+    }
+    if (changed_idle != 0) {
+        g_source_remove(changed_idle);
+        changed_idle = 0;
+    }
+    changed_func = NULL;
+}
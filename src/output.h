@@ -0,0 +1,46 @@
+/*
+ * Outputs (monitors).
+ *
+ * Indicators are sized from the geometry of the output they are shown on
+ * rather than an assumed 1920x1080, so the surface - and the buffer GTK
+ * allocates for it at the output's scale - is exactly as large as needed
+ * and the compositor never has to rescale it. The monitor list is watched
+ * so indicators can be rebuilt when an output is plugged in, removed or
+ * changes mode or scale.
+ */
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <gtk/gtk.h>
+
+#define OUTPUT_FALLBACK_WIDTH 1920
+#define OUTPUT_FALLBACK_HEIGHT 1080
+
+typedef void (*OutputsChangedFunc)(gpointer user_data);
+
+// Output with the given connector name ("DP-1") or index ("0"), NULL if absent
+GdkMonitor *output_find(const char *name);
+
+// First output, NULL if there is none (yet)
+GdkMonitor *output_first(void);
+
+// Output a widget is currently shown on, else the first output
+GdkMonitor *output_for_widget(GtkWidget *widget);
+
+// Logical size of monitor; the fallback size if monitor is NULL
+void output_get_size(GdkMonitor *monitor, int *width, int *height);
+
+// Scale of monitor (fractional where GTK supports it), 1.0 if NULL
+double output_get_scale(GdkMonitor *monitor);
+
+// Human readable name for logs ("DP-1" or "?")
+const char *output_get_name(GdkMonitor *monitor);
+
+// Call func once per main loop iteration in which outputs were added or
+// removed or changed geometry or scale
+void output_watch(OutputsChangedFunc func, gpointer user_data);
+
+void output_unwatch(void);
+
+#endif /* OUTPUT_H */
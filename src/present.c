@@ -0,0 +1,98 @@
+#include "present.h"
+
+#include <string.h>
+
+#include "protocol.h"
+#include "stats.h"
+#include "trace.h"
+
+typedef struct {
+    GdkFrameClock *clock;   // Referenced while pending
+    gint64 frame;           // Frame counter the value was painted in
+    gint64 received;
+    gint64 sent;
+    uint32_t trace_id;
+    gulong after_paint;     // Handler on the clock's "after-paint"
+    guint timeout_id;       // Last chance if the clock does not paint again
+    char key[UPDATE_KEY_MAX];
+} PendingFrame;
+
+static GPtrArray *pending = NULL;   // PendingFrame *
+
+static void pending_free(PendingFrame *frame) {
+    g_signal_handler_disconnect(frame->clock, frame->after_paint);
+    if (frame->timeout_id != 0) {
+        g_source_remove(frame->timeout_id);
+    }
+    g_object_unref(frame->clock);
+    g_free(frame);
+}
+
+// TRUE once the frame's fate is known (presented, unknown or expired)
+static gboolean pending_resolve(PendingFrame *frame, gboolean expired) {
+    GdkFrameTimings *timings = gdk_frame_clock_get_timings(frame->clock, frame->frame);
+    
+    if (timings == NULL || (expired && !gdk_frame_timings_get_complete(timings))) {
+        // Fell out of the clock's history or the compositor never answered
+        stats_record_presented(frame->received, frame->sent, 0);
+        return TRUE;
+    }
+    if (!gdk_frame_timings_get_complete(timings)) {
+        return FALSE;
+    }
+    
+    gint64 presented = gdk_frame_timings_get_presentation_time(timings);
+    stats_record_presented(frame->received, frame->sent, presented);
+    if (presented > 0) {
+        trace_event_at(TRACE_PRESENTED, frame->trace_id, frame->key, presented);
+    }
+    return TRUE;
+}
+
+// Feedback for earlier frames has usually arrived by the next paint
+static void on_after_paint(GdkFrameClock *clock, gpointer data) {
+    PendingFrame *frame = data;
+    (void)clock;
+    
+    if (pending_resolve(frame, FALSE)) {
+        g_ptr_array_remove_fast(pending, frame);
+    }
+}
+
+static gboolean on_timeout(gpointer data) {
+    PendingFrame *frame = data;
+    
+    frame->timeout_id = 0;
+    pending_resolve(frame, TRUE);
+    g_ptr_array_remove_fast(pending, frame);
+    return G_SOURCE_REMOVE;
+}
+
+void present_track(GtkWidget *widget, const char *key, gint64 received, gint64 sent, uint32_t trace_id) {
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(widget);
+    if (clock == NULL || (!trace_enabled && !stats_presentation_wanted())) {
+        return;
+    }
+    
+    if (pending == NULL) {
+        pending = g_ptr_array_new_with_free_func((GDestroyNotify)pending_free);
+    }
+    
+    PendingFrame *frame = g_new0(PendingFrame, 1);
+    frame->clock = g_object_ref(clock);
+    frame->frame = gdk_frame_clock_get_frame_counter(clock);
+    frame->received = received;
+    frame->sent = sent;
+    frame->trace_id = trace_id;
+    g_strlcpy(frame->key, key, sizeof(frame->key));
+    frame->after_paint = g_signal_connect(clock, "after-paint", G_CALLBACK(on_after_paint), frame);
+    frame->timeout_id = g_timeout_add(PRESENT_TIMEOUT_MS, on_timeout, frame);
+    g_ptr_array_add(pending, frame);
+}
+
+void present_shutdown(void) {
+    if (pending) {
+        g_ptr_array_free(pending, TRUE);
+        pending = NULL;
+    }
+}
@@ -0,0 +1,35 @@
+/*
+ * On-screen latency from presentation feedback.
+ *
+ * GTK's Wayland backend requests wp_presentation feedback for every frame
+ * it commits and stores the result in the frame clock's GdkFrameTimings.
+ * When a new value is drawn we remember which frame it went into and look
+ * at those timings again after every later paint of the same frame clock
+ * (and once more at the timeout, in case nothing paints any more) until
+ * the compositor has reported the frame as presented, then record receive
+ * -> scanout (and sender -> scanout when the sender attached a timestamp)
+ * in the stats and the trace.
+ *
+ * Tracking costs a signal handler and a timer per drawn value, so it only
+ * runs while someone looks: with --trace, or once the stats have been
+ * requested (the "stats" socket command, ingest-bench --stats).
+ *
+ * Compositors without wp_presentation complete the timings without a
+ * presentation time; those frames are counted as presentation_unknown.
+ */
+
+#ifndef PRESENT_H
+#define PRESENT_H
+
+#include <gtk/gtk.h>
+#include <stdint.h>
+
+#define PRESENT_TIMEOUT_MS 1000     // Give up on feedback after this long
+
+// Call from a draw function that painted a new value (GTK thread only)
+void present_track(GtkWidget *widget, const char *key, gint64 received, gint64 sent, uint32_t trace_id);
+
+// Drop everything still pending
+void present_shutdown(void);
+
+#endif /* PRESENT_H */
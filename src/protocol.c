@@ -0,0 +1,143 @@
+#define _POSIX_C_SOURCE 200809L
+#include "protocol.h"
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+
+void update_batch_clear(UpdateBatch *batch) {
+    batch->count = 0;
+}
+
+int update_batch_put(UpdateBatch *batch, const Update *update, Update *replaced) {
+    for (int i = 0; i < batch->count; i++) {
+        if (batch->items[i].index == update->index && strcmp(batch->items[i].key, update->key) == 0) {
+            if (replaced) {
+                *replaced = batch->items[i];
+            }
+            batch->items[i] = *update;
+            return 1;
+        }
+    }
+    
+    if (batch->count == UPDATE_BATCH_MAX) {
+        return -1;
+    }
+    
+    batch->items[batch->count++] = *update;
+    return 0;
+}
+
+int update_batch_set(UpdateBatch *batch, const char *key, float value, int64_t received) {
+    Update update = { .value = value, .received = received };
+    
+    strncpy(update.key, key, sizeof(update.key) - 1);
+    return update_batch_put(batch, &update, NULL);
+}
+
+// Keys end up in stats output and bus names, keep them plain
+int protocol_valid_key(const char *key) {
+    if (*key == '\0' || strlen(key) >= UPDATE_KEY_MAX) {
+        return 0;
+    }
+    for (const char *c = key; *c; c++) {
+        if (!g_ascii_isalnum(*c) && *c != '_' && *c != '-' && *c != '.') {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Parse a percentage in the 0 - 100 range (locale independent)
+static int parse_percent(const char *str, float *value) {
+    char *endptr;
+    double percent = g_ascii_strtod(str, &endptr);
+    
+    if (endptr == str || *endptr != '\0' || percent < 0.0 || percent > 100.0) {
+        return -1;
+    }
+    *value = (float)(percent / 100.0);
+    return 0;
+}
+
+// Sender wall clock time in µs since the epoch
+static int parse_timestamp(const char *str, int64_t *timestamp) {
+    char *endptr;
+    long long value = strtoll(str, &endptr, 10);
+    
+    if (endptr == str || *endptr != '\0' || value <= 0) {
+        return -1;
+    }
+    *timestamp = value;
+    return 0;
+}
+
+// "40/55/12": one update per segment, all with the same key and timestamp
+static int parse_vector(char *value_str, const Update *base, UpdateBatch *batch, int *failed) {
+    char *saveptr = NULL;
+    int parsed = 0;
+    Update update = *base;
+    
+    for (char *part = strtok_r(value_str, "/", &saveptr); part != NULL; part = strtok_r(NULL, "/", &saveptr)) {
+        if (update.index >= UPDATE_SEGMENTS_MAX || parse_percent(part, &update.value) < 0 ||
+            update_batch_put(batch, &update, NULL) < 0) {
+            (*failed)++;
+        } else {
+            parsed++;
+        }
+        update.index++;
+    }
+    return parsed;
+}
+
+int protocol_parse_line(char *line, const char *default_key, int64_t received,
+                        UpdateBatch *batch, int *errors) {
+    int parsed = 0;
+    int failed = 0;
+    char *saveptr = NULL;
+    
+    for (char *token = strtok_r(line, " \t\r\n,;", &saveptr); token != NULL;
+         token = strtok_r(NULL, " \t\r\n,;", &saveptr)) {
+        const char *key = default_key;
+        char *value_str = token;
+        char *colon = strchr(token, ':');
+        char *at;
+        Update update = { .received = received };
+        
+        if (colon != NULL) {
+            *colon = '\0';
+            key = token;
+            value_str = colon + 1;
+        }
+        
+        // Optional sender timestamp, only used for tracing
+        if ((at = strchr(value_str, '@')) != NULL) {
+            *at = '\0';
+            if (parse_timestamp(at + 1, &update.sent) < 0) {
+                failed++;
+                continue;
+            }
+        }
+        
+        if (protocol_valid_key(key) && strchr(value_str, '/') != NULL) {
+            strcpy(update.key, key);
+            parsed += parse_vector(value_str, &update, batch, &failed);
+            continue;
+        }
+        if (!protocol_valid_key(key) || parse_percent(value_str, &update.value) < 0) {
+            failed++;
+            continue;
+        }
+        strcpy(update.key, key);
+        if (update_batch_put(batch, &update, NULL) < 0) {
+            failed++;
+            continue;
+        }
+        parsed++;
+    }
+    
+    if (errors) {
+        *errors += failed;
+    }
+    return parsed;
+}
@@ -0,0 +1,59 @@
+/*
+ * Update message parsing shared by every input path.
+ *
+ * A line carries one or more values, separated by whitespace, ',' or ';':
+ *
+ *   60                          plain percentage for the default key
+ *   volume:60                   key:value
+ *   volume:60 brightness:80     batch
+ *   volume:60@1712345678901234  value with the sender's wall clock time (µs)
+ *   cpu:40/55/12/80             vector for a segmented bar, one value per segment
+ *
+ * Keys are limited to letters, digits, '_', '-' and '.'.
+ *
+ * Parsed values are collected in an UpdateBatch that keeps only the latest
+ * value per key and segment, so a burst of lines collapses into one apply
+ * per key and segment.
+ */
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+
+#define UPDATE_KEY_MAX 32
+#define UPDATE_SEGMENTS_MAX 128   // Values in one vector
+#define UPDATE_BATCH_MAX 256
+
+typedef struct {
+    char key[UPDATE_KEY_MAX];
+    float value;            // 0.0 - 1.0
+    uint16_t index;         // Segment within a vector, 0 for a plain value
+    int64_t received;       // Monotonic time (µs) the value arrived, 0 if unknown
+    int64_t sent;           // Sender's wall clock time (µs) from "@T", 0 if not given
+    uint32_t trace_id;      // Tracing correlation id, 0 when not traced
+} Update;
+
+typedef struct {
+    Update items[UPDATE_BATCH_MAX];
+    int count;
+} UpdateBatch;
+
+void update_batch_clear(UpdateBatch *batch);
+
+// Store a value, replacing any earlier value for the same key (segment 0).
+// Returns 0 if added, 1 if an earlier value was replaced, -1 if the batch is full.
+int update_batch_set(UpdateBatch *batch, const char *key, float value, int64_t received);
+
+// Same for a complete Update (key and segment); the value it replaced is copied to *replaced (may be NULL)
+int update_batch_put(UpdateBatch *batch, const Update *update, Update *replaced);
+
+// Whether key is usable: 1 - 31 characters of [A-Za-z0-9_.-]
+int protocol_valid_key(const char *key);
+
+// Parse one line into the batch. Returns the number of values stored;
+// malformed tokens are counted in *errors (may be NULL) and skipped.
+int protocol_parse_line(char *line, const char *default_key, int64_t received,
+                        UpdateBatch *batch, int *errors);
+
+#endif /* PROTOCOL_H */
@@ -0,0 +1,225 @@
+#define _GNU_SOURCE
+#include "ratelimit.h"
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "log.h"
+#include "stats.h"
+#include "trace.h"
+
+#define RATELIMIT_PRUNE_ABOVE 64    // Idle buckets are only swept beyond this many
+
+struct Producer {
+    guint64 id;             // uid << 32 | process group
+    int refs;               // Open connections
+    double tokens;
+    gint64 refilled;        // Monotonic time of the last refill
+    UpdateBatch *held;      // Over the limit, waiting for tokens (NULL if none)
+};
+
+static double rate = 0.0;
+static double burst = 0.0;
+static RateLimitReleaseFunc release_func = NULL;
+static GHashTable *producers = NULL;    // id -> Producer *
+static GSource *release_source = NULL;
+
+static void producer_free(gpointer data) {
+    Producer *producer = data;
+    g_free(producer->held);
+    g_free(producer);
+}
+
+static void refill(Producer *producer, gint64 now) {
+    producer->tokens = MIN(burst, producer->tokens + (now - producer->refilled) * rate / G_USEC_PER_SEC);
+    producer->refilled = now;
+}
+
+// When the producer will have a whole token
+static gint64 token_due(const Producer *producer) {
+    if (producer->tokens >= 1.0) {
+        return producer->refilled;
+    }
+    return producer->refilled + (gint64)((1.0 - producer->tokens) * G_USEC_PER_SEC / rate) + 1;
+}
+
+static void schedule_release(gint64 due) {
+    gint64 ready = g_source_get_ready_time(release_source);
+    
+    if (ready == -1 || due < ready) {
+        g_source_set_ready_time(release_source, due);
+    }
+}
+
+// Hand held updates on for every producer that has tokens again
+static gboolean release_dispatch(GSource *source, GSourceFunc callback, gpointer user_data) {
+    (void)callback; (void)user_data;
+    gint64 now = g_get_monotonic_time();
+    gint64 next = -1;
+    GHashTableIter iter;
+    Producer *producer;
+    gboolean prune = g_hash_table_size(producers) > RATELIMIT_PRUNE_ABOVE;
+    
+    g_source_set_ready_time(source, -1);
+    g_hash_table_iter_init(&iter, producers);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&producer)) {
+        refill(producer, now);
+        
+        if (producer->held != NULL && producer->tokens >= 1.0) {
+            // Everything held was coalesced into one message: it goes at once, for one token
+            for (int i = 0; i < producer->held->count; i++) {
+                release_func(&producer->held->items[i]);
+                stats_inc(&stats.rate_released);
+            }
+            producer->tokens -= 1.0;
+            g_free(producer->held);
+            producer->held = NULL;
+        }
+        
+        if (producer->held != NULL) {
+            gint64 due = token_due(producer);
+            next = next == -1 ? due : MIN(next, due);
+        } else if (prune && producer->refs == 0 && producer->tokens >= burst) {
+            g_hash_table_iter_remove(&iter);
+        }
+    }
+    
+    if (next != -1) {
+        g_source_set_ready_time(source, next);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs release_source_funcs = {
+    NULL, NULL, release_dispatch, NULL, NULL, NULL
+};
+
+gboolean ratelimit_parse(const char *text, double *limit, double *burst_size) {
+    char *end;
+    double parsed_rate = g_ascii_strtod(text, &end);
+    double parsed_burst = parsed_rate / 5.0;
+    
+    if (end == text || parsed_rate < 0.0) {
+        return FALSE;
+    }
+    if (*end == ':') {
+        const char *start = end + 1;
+        parsed_burst = g_ascii_strtod(start, &end);
+        if (end == start || parsed_burst < 1.0) {
+            return FALSE;
+        }
+    }
+    if (*end != '\0') {
+        return FALSE;
+    }
+    
+    *limit = parsed_rate;
+    *burst_size = parsed_burst;
+    return TRUE;
+}
+
+void ratelimit_init(GMainContext *context, double limit, double burst_size, RateLimitReleaseFunc release) {
+    rate = limit;
+    burst = MAX(1.0, burst_size);
+    release_func = release;
+    if (rate <= 0.0) {
+        return;
+    }
+    
+    producers = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL, producer_free);
+    release_source = g_source_new(&release_source_funcs, sizeof(GSource));
+    g_source_set_name(release_source, "linestatus-ratelimit-release");
+    g_source_attach(release_source, context);
+}
+
+void ratelimit_shutdown(void) {
+    if (release_source != NULL) {
+        g_source_destroy(release_source);
+        g_source_unref(release_source);
+        release_source = NULL;
+    }
+    if (producers != NULL) {
+        g_hash_table_destroy(producers);
+        producers = NULL;
+    }
+}
+
+Producer *ratelimit_attach(int fd) {
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    
+    if (producers == NULL || getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) < 0) {
+        return NULL;
+    }
+    
+    // One-shot senders may already be gone by now - fall back to their pid
+    // (0 for peers in another pid namespace: one bucket for their uid)
+    pid_t group = cred.pid > 0 ? getpgid(cred.pid) : -1;
+    guint64 id = (guint64)cred.uid << 32 | (guint32)(group > 0 ? group : cred.pid);
+    
+    Producer *producer = g_hash_table_lookup(producers, &id);
+    if (producer == NULL) {
+        producer = g_new0(Producer, 1);
+        producer->id = id;
+        producer->tokens = burst;
+        producer->refilled = g_get_monotonic_time();
+        g_hash_table_insert(producers, &producer->id, producer);
+    }
+    producer->refs++;
+    return producer;
+}
+
+void ratelimit_detach(Producer *producer) {
+    if (producer == NULL) {
+        return;
+    }
+    producer->refs--;
+    
+    // Sweep now and then even if nobody is over the limit
+    if (producer->refs == 0 && g_hash_table_size(producers) > RATELIMIT_PRUNE_ABOVE) {
+        schedule_release(g_get_monotonic_time());
+    }
+}
+
+gboolean ratelimit_admit(Producer *producer, const UpdateBatch *message) {
+    Update replaced;
+    
+    if (producer == NULL || message->count == 0) {
+        return TRUE;
+    }
+    refill(producer, g_get_monotonic_time());
+    
+    // Nothing may overtake values that are already held
+    if (producer->held == NULL && producer->tokens >= 1.0) {
+        producer->tokens -= 1.0;
+        return TRUE;
+    }
+    
+    if (producer->held == NULL) {
+        producer->held = g_new(UpdateBatch, 1);
+        update_batch_clear(producer->held);
+    }
+    
+    for (int i = 0; i < message->count; i++) {
+        const Update *update = &message->items[i];
+        
+        stats_inc(&stats.rate_limited);
+        int result = update_batch_put(producer->held, update, &replaced);
+        if (result > 0) {
+            stats_inc(&stats.coalesced);
+            trace_event(TRACE_COALESCED, replaced.trace_id, replaced.key);
+        } else if (result < 0) {
+            stats_inc(&stats.dropped);
+            trace_event(TRACE_COALESCED, update->trace_id, update->key);
+        }
+    }
+    schedule_release(token_due(producer));
+    return FALSE;
+}
+
+gint64 ratelimit_wait_us(Producer *producer) {
+    if (producer == NULL) {
+        return 0;
+    }
+    return MAX(0, token_due(producer) - g_get_monotonic_time());
+}
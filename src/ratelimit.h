@@ -0,0 +1,57 @@
+/*
+ * Per-producer token buckets for socket updates.
+ *
+ * A producer is identified by the peer credentials of its connections:
+ * the process group of the peer (the pid if that is gone), per uid. A
+ * shell loop running send-status spawns a new socat every time, but all of
+ * them share the loop's process group, so they share one bucket as well;
+ * a persistent client simply keeps its bucket for the connection lifetime.
+ *
+ * Every message (one parsed line, however many values or segments it
+ * carries) costs one token, tokens refill at the configured rate up to the
+ * burst size. A message is admitted or held as a whole, so the segments of
+ * a vector never get split. Messages over the limit are not refused: their
+ * values are held (latest per key and segment) and handed on together as
+ * soon as the producer has a token again, so a flooding producer only ever
+ * costs its share while its last values still make it to the screen.
+ *
+ * Runs on the ingest thread.
+ */
+
+#ifndef RATELIMIT_H
+#define RATELIMIT_H
+
+#include <glib.h>
+
+#include "protocol.h"
+
+#define RATELIMIT_DEFAULT_RATE 500.0    // Messages per second per producer
+#define RATELIMIT_DEFAULT_BURST 100.0
+
+typedef struct Producer Producer;
+
+// "RATE" or "RATE:BURST" (messages per second, 0 = unlimited); burst defaults to rate / 5
+gboolean ratelimit_parse(const char *text, double *rate, double *burst);
+
+// Receives held updates once their producer is below its limit again
+typedef void (*RateLimitReleaseFunc)(const Update *update);
+
+// rate <= 0 disables limiting (ratelimit_attach() then returns NULL)
+void ratelimit_init(GMainContext *context, double rate, double burst, RateLimitReleaseFunc release);
+
+// Drop all producers and everything they still hold
+void ratelimit_shutdown(void);
+
+// Producer behind a connected socket, NULL if unlimited or unknown
+Producer *ratelimit_attach(int fd);
+
+// The connection is gone; the bucket outlives it until it is full again
+void ratelimit_detach(Producer *producer);
+
+// TRUE if all values of one message may pass now, FALSE if they were all held for later
+gboolean ratelimit_admit(Producer *producer, const UpdateBatch *message);
+
+// Microseconds until the producer has a token again (0 if it has one now)
+gint64 ratelimit_wait_us(Producer *producer);
+
+#endif /* RATELIMIT_H */
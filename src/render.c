@@ -0,0 +1,210 @@
+#include "render.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+// Clear the whole surface to transparent
+static void clear(cairo_t *cr) {
+    cairo_set_source_rgba(cr, 0, 0, 0, 0);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+}
+
+// The run [start, start + extent) along the line; vertical lines run bottom to top
+static void bar_rectangle(const Renderer *renderer, cairo_t *cr, int width, int height, double start, double extent) {
+    if (renderer->vertical) {
+        cairo_rectangle(cr, 0, height - start - extent, width, extent);
+    } else {
+        cairo_rectangle(cr, start, 0, extent, height);
+    }
+}
+
+static void draw_bar(Renderer *renderer, cairo_t *cr, int width, int height, int scale, float value) {
+    (void)scale;
+    int length = renderer->vertical ? height : width;
+    
+    clear(cr);
+    cairo_set_source_rgb(cr, renderer->r, renderer->g, renderer->b);
+    bar_rectangle(renderer, cr, width, height, 0, (int)(length * value));
+    cairo_fill(cr);
+}
+
+static void draw_centered(Renderer *renderer, cairo_t *cr, int width, int height, int scale, float value) {
+    (void)scale;
+    int length = renderer->vertical ? height : width;
+    int extent = (int)(length * value);
+    
+    clear(cr);
+    cairo_set_source_rgb(cr, renderer->r, renderer->g, renderer->b);
+    bar_rectangle(renderer, cr, width, height, (length - extent) / 2, extent);
+    cairo_fill(cr);
+}
+
+static void draw_gradient(Renderer *renderer, cairo_t *cr, int width, int height, int scale, float value) {
+    (void)scale;
+    int length = renderer->vertical ? height : width;
+    
+    // The pattern spans the full line, so the visible part shows where the value is
+    if (renderer->gradient == NULL || renderer->gradient_length != length) {
+        if (renderer->gradient != NULL) {
+            cairo_pattern_destroy(renderer->gradient);
+        }
+        renderer->gradient = renderer->vertical ? cairo_pattern_create_linear(0, length, 0, 0)
+                                                : cairo_pattern_create_linear(0, 0, length, 0);
+        for (int i = 0; i < renderer->num_stops; i++) {
+            const RenderStop *stop = &renderer->stops[i];
+            cairo_pattern_add_color_stop_rgb(renderer->gradient, stop->position, stop->r, stop->g, stop->b);
+        }
+        renderer->gradient_length = length;
+    }
+    
+    clear(cr);
+    cairo_set_source(cr, renderer->gradient);
+    bar_rectangle(renderer, cr, width, height, 0, (int)(length * value));
+    cairo_fill(cr);
+}
+
+static void draw_ramp(Renderer *renderer, cairo_t *cr, int width, int height, int scale, float value) {
+    (void)scale;
+    int length = renderer->vertical ? height : width;
+    const float *color = renderer->ramp[(int)(value * (RENDER_RAMP_STEPS - 1) + 0.5f)];
+    
+    clear(cr);
+    cairo_set_source_rgb(cr, color[0], color[1], color[2]);
+    bar_rectangle(renderer, cr, width, height, 0, (int)(length * value));
+    cairo_fill(cr);
+}
+
+static void draw_segmented(Renderer *renderer, cairo_t *cr, int width, int height, int scale, float value) {
+    (void)value;
+    segments_render(renderer->segments, cr, width, height, scale, renderer->vertical);
+}
+
+static void draw_sparkline(Renderer *renderer, cairo_t *cr, int width, int height, int scale, float value) {
+    (void)scale; (void)value;
+    history_render(renderer->history, cr, width, height, renderer->vertical, renderer->r, renderer->g, renderer->b);
+}
+
+// The surface was sized to the bar: one opaque fill, nothing to clear
+static void draw_fill(Renderer *renderer, cairo_t *cr, int width, int height, int scale, float value) {
+    (void)width; (void)height; (void)scale; (void)value;
+    cairo_set_source_rgb(cr, renderer->r, renderer->g, renderer->b);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+}
+
+// Color of the first stop at or above position (the last one beyond it)
+static const RenderStop *ramp_stop(const Renderer *renderer, float position) {
+    for (int i = 0; i < renderer->num_stops; i++) {
+        if (position <= renderer->stops[i].position) {
+            return &renderer->stops[i];
+        }
+    }
+    return &renderer->stops[renderer->num_stops - 1];
+}
+
+void renderer_configure(Renderer *renderer, RenderStyle style, gboolean vertical,
+                        double r, double g, double b, const RenderStop *stops, int num_stops) {
+    static const RenderDrawFunc draw_funcs[] = {
+        [RENDER_BAR] = draw_bar,
+        [RENDER_CENTERED] = draw_centered,
+        [RENDER_GRADIENT] = draw_gradient,
+        [RENDER_RAMP] = draw_ramp,
+        [RENDER_SEGMENTED] = draw_segmented,
+        [RENDER_SPARKLINE] = draw_sparkline,
+        [RENDER_FILL] = draw_fill,
+    };
+    
+    renderer_clear(renderer);
+    renderer->style = style;
+    renderer->draw = draw_funcs[style];
+    renderer->vertical = vertical;
+    renderer->r = r;
+    renderer->g = g;
+    renderer->b = b;
+    
+    if (num_stops > 0) {
+        memcpy(renderer->stops, stops, MIN(num_stops, RENDER_MAX_STOPS) * sizeof(RenderStop));
+        renderer->num_stops = MIN(num_stops, RENDER_MAX_STOPS);
+    } else if (style == RENDER_RAMP) {
+        // Red while low, the line color otherwise
+        renderer->stops[0] = (RenderStop){ 0.15f, 1.0, 0.0, 0.0 };
+        renderer->stops[1] = (RenderStop){ 1.0f, r, g, b };
+        renderer->num_stops = 2;
+    } else {
+        // From a dimmed line color to the line color
+        renderer->stops[0] = (RenderStop){ 0.0f, r * 0.4, g * 0.4, b * 0.4 };
+        renderer->stops[1] = (RenderStop){ 1.0f, r, g, b };
+        renderer->num_stops = 2;
+    }
+    
+    // Every possible value's color, looked up instead of searched per frame
+    for (int i = 0; i < RENDER_RAMP_STEPS; i++) {
+        const RenderStop *stop = ramp_stop(renderer, (float)i / (RENDER_RAMP_STEPS - 1));
+        renderer->ramp[i][0] = stop->r;
+        renderer->ramp[i][1] = stop->g;
+        renderer->ramp[i][2] = stop->b;
+    }
+}
+
+void renderer_clear(Renderer *renderer) {
+    if (renderer->gradient != NULL) {
+        cairo_pattern_destroy(renderer->gradient);
+        renderer->gradient = NULL;
+    }
+    renderer->gradient_length = 0;
+}
+
+gboolean render_parse_style(const char *str, RenderStyle *style) {
+    static const struct {
+        const char *name;
+        RenderStyle style;
+    } styles[] = {
+        { "bar", RENDER_BAR },
+        { "centered", RENDER_CENTERED },
+        { "gradient", RENDER_GRADIENT },
+        { "ramp", RENDER_RAMP },
+    };
+    
+    for (size_t i = 0; i < G_N_ELEMENTS(styles); i++) {
+        if (strcmp(str, styles[i].name) == 0) {
+            *style = styles[i].style;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static int compare_stops(const void *a, const void *b) {
+    float pa = ((const RenderStop *)a)->position;
+    float pb = ((const RenderStop *)b)->position;
+    return (pa > pb) - (pa < pb);
+}
+
+gboolean render_parse_stops(const char *str, RenderStop *stops, int *num_stops) {
+    char **parts = g_strsplit(str, ",", -1);
+    gboolean ok = parts[0] != NULL;
+    int count = 0;
+    
+    for (int i = 0; ok && parts[i] != NULL; i++) {
+        char *colon = strchr(parts[i], ':');
+        char *end = NULL;
+        double percent = colon != NULL ? g_ascii_strtod(parts[i], &end) : -1;
+        
+        ok = count < RENDER_MAX_STOPS && colon != NULL && end == colon && percent >= 0 && percent <= 100 &&
+             config_parse_color(colon + 1, &stops[count].r, &stops[count].g, &stops[count].b);
+        if (ok) {
+            stops[count++].position = (float)(percent / 100.0);
+        }
+    }
+    g_strfreev(parts);
+    
+    if (ok) {
+        qsort(stops, count, sizeof(RenderStop), compare_stops);
+        *num_stops = count;
+    }
+    return ok;
+}
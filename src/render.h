@@ -0,0 +1,79 @@
+/*
+ * Bar styles.
+ *
+ * A Renderer is configured once - style, orientation, colors - and picks
+ * the draw function for that combination, so a frame is one indirect call
+ * with no string compares or parsing. Value-to-color ramps are
+ * precomputed into a lookup table and gradients are cached as Cairo
+ * patterns until the bar length changes; drawing allocates nothing.
+ *
+ * Color stops are written "PCT:RRGGBB,...". A gradient interpolates
+ * between them along the line; a ramp colors the whole bar with the first
+ * stop at or above the value ("15:FF0000,100:00CC66" is red up to 15%).
+ */
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <cairo.h>
+#include <glib.h>
+
+#include "history.h"
+#include "segments.h"
+
+#define RENDER_RAMP_STEPS 256
+#define RENDER_MAX_STOPS 8
+
+typedef enum {
+    RENDER_BAR,         // Fill from the start of the line (default)
+    RENDER_CENTERED,    // Fill grows from the middle towards both ends
+    RENDER_GRADIENT,    // Bar painted with a gradient along the line
+    RENDER_RAMP,        // Bar in one color chosen by the value
+    RENDER_SEGMENTED,   // Many values (segments.h)
+    RENDER_SPARKLINE,   // Recent values (history.h)
+    RENDER_FILL,        // The surface is exactly the bar (shrink-to-fit)
+} RenderStyle;
+
+typedef struct {
+    float position;     // 0.0 - 1.0
+    double r, g, b;
+} RenderStop;
+
+typedef struct Renderer Renderer;
+
+typedef void (*RenderDrawFunc)(Renderer *renderer, cairo_t *cr, int width, int height, int scale, float value);
+
+struct Renderer {
+    RenderStyle style;
+    RenderDrawFunc draw;                // Chosen by renderer_configure
+    gboolean vertical;
+    double r, g, b;
+    RenderStop stops[RENDER_MAX_STOPS];
+    int num_stops;
+    float ramp[RENDER_RAMP_STEPS][3];   // Value -> color (RENDER_RAMP)
+    cairo_pattern_t *gradient;          // Cached (RENDER_GRADIENT), NULL until first use
+    int gradient_length;
+    Segments *segments;                 // Not owned (RENDER_SEGMENTED)
+    History *history;                   // Not owned (RENDER_SPARKLINE)
+};
+
+// Set up renderer for style, orientation and line color. stops may be NULL
+// (num_stops 0) to derive them from the line color. Drops cached patterns.
+void renderer_configure(Renderer *renderer, RenderStyle style, gboolean vertical,
+                        double r, double g, double b, const RenderStop *stops, int num_stops);
+
+// Release cached patterns
+void renderer_clear(Renderer *renderer);
+
+// Draw value (0.0 - 1.0) over width x height; scale is the surface scale factor
+static inline void renderer_draw(Renderer *renderer, cairo_t *cr, int width, int height, int scale, float value) {
+    renderer->draw(renderer, cr, width, height, scale, value);
+}
+
+// "bar", "centered", "gradient" or "ramp"
+gboolean render_parse_style(const char *str, RenderStyle *style);
+
+// "PCT:RRGGBB,..." sorted by position; returns FALSE on a malformed list
+gboolean render_parse_stops(const char *str, RenderStop *stops, int *num_stops);
+
+#endif /* RENDER_H */
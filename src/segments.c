@@ -0,0 +1,171 @@
+#include "segments.h"
+
+struct Segments {
+    guint count;
+    gboolean stacked;
+    float values[SEGMENTS_MAX];
+    float sum;                      // Of all values, kept up to date by segments_set
+    float colors[SEGMENTS_MAX][3];
+    
+    // Layout along the bar in image pixels: where each fill starts and how long it is
+    int start[SEGMENTS_MAX];
+    int extent[SEGMENTS_MAX];
+    int drawn_start[SEGMENTS_MAX];  // What the cached image currently shows
+    int drawn_extent[SEGMENTS_MAX];
+    
+    cairo_surface_t *image;
+    int image_length;               // Image size along / across the bar
+    int image_thickness;
+    gboolean vertical;
+};
+
+Segments *segments_new(guint count, gboolean stacked) {
+    Segments *segments = g_new0(Segments, 1);
+    segments->count = CLAMP(count, 1, SEGMENTS_MAX);
+    segments->stacked = stacked;
+    for (guint i = 0; i < segments->count; i++) {
+        segments_set_color(segments, i, 1.0, 0.647, 0.0);
+    }
+    return segments;
+}
+
+void segments_free(Segments *segments) {
+    if (segments == NULL) {
+        return;
+    }
+    if (segments->image != NULL) {
+        cairo_surface_destroy(segments->image);
+    }
+    g_free(segments);
+}
+
+void segments_set_color(Segments *segments, guint index, double r, double g, double b) {
+    if (index >= segments->count) {
+        return;
+    }
+    segments->colors[index][0] = r;
+    segments->colors[index][1] = g;
+    segments->colors[index][2] = b;
+    segments->drawn_extent[index] = -1; // Repaint with the new color
+}
+
+gboolean segments_set(Segments *segments, guint index, float value) {
+    if (index >= segments->count || segments->values[index] == value) {
+        return FALSE;
+    }
+    segments->sum += value - segments->values[index];
+    segments->values[index] = value;
+    return TRUE;
+}
+
+guint segments_count(const Segments *segments) {
+    return segments->count;
+}
+
+float segments_mean(const Segments *segments) {
+    return CLAMP(segments->sum / segments->count, 0.0f, 1.0f);
+}
+
+// Extents of all segments for a bar length pixels long
+static void segments_layout(Segments *segments, int length) {
+    const int n = (int)segments->count;
+    const float slot = (float)length / n;
+    float *restrict values = segments->values;
+    int *restrict start = segments->start;
+    int *restrict extent = segments->extent;
+    
+    // Hot loop: independent per segment, no branches, vectorizes at -O2
+    for (int i = 0; i < n; i++) {
+        start[i] = (int)(i * slot);
+        extent[i] = (int)(values[i] * slot + 0.5f);
+    }
+    
+    if (segments->stacked) {
+        // Each segment continues where the previous one ended
+        int offset = 0;
+        for (int i = 0; i < n; i++) {
+            start[i] = offset;
+            offset += extent[i];
+        }
+    } else if (slot >= 4.0f) {
+        // Side by side: one pixel gap so neighbours stay apart
+        for (int i = 0; i < n; i++) {
+            int room = (int)((i + 1) * slot) - start[i] - 1;
+            extent[i] = MIN(extent[i], room);
+        }
+    }
+}
+
+// Rectangle of a run along the bar in image coordinates
+static void bar_rectangle(Segments *segments, cairo_t *cr, int start, int extent) {
+    if (segments->vertical) {
+        cairo_rectangle(cr, 0, segments->image_length - start - extent, segments->image_thickness, extent);
+    } else {
+        cairo_rectangle(cr, start, 0, extent, segments->image_thickness);
+    }
+}
+
+void segments_render(Segments *segments, cairo_t *cr, int width, int height, int scale, gboolean vertical) {
+    int length = (vertical ? height : width) * scale;
+    int thickness = (vertical ? width : height) * scale;
+    guint changed = 0;
+    
+    // New size or orientation: new image, every segment counts as changed
+    if (segments->image == NULL || segments->vertical != vertical ||
+        segments->image_length != length || segments->image_thickness != thickness) {
+        if (segments->image != NULL) {
+            cairo_surface_destroy(segments->image);
+        }
+        segments->image = vertical ? cairo_image_surface_create(CAIRO_FORMAT_ARGB32, thickness, length)
+                                   : cairo_image_surface_create(CAIRO_FORMAT_ARGB32, length, thickness);
+        segments->vertical = vertical;
+        segments->image_length = length;
+        segments->image_thickness = thickness;
+        for (guint i = 0; i < segments->count; i++) {
+            segments->drawn_extent[i] = -1;
+        }
+    }
+    segments_layout(segments, length);
+    
+    cairo_t *image_cr = cairo_create(segments->image);
+    
+    // Clear where changed segments were, then paint where they are now
+    // (two passes, so a stacked neighbour that moved is not erased)
+    cairo_set_operator(image_cr, CAIRO_OPERATOR_CLEAR);
+    for (guint i = 0; i < segments->count; i++) {
+        if (segments->start[i] == segments->drawn_start[i] && segments->extent[i] == segments->drawn_extent[i]) {
+            continue;
+        }
+        if (segments->drawn_extent[i] < 0) {
+            // Never drawn (or new color): clear its whole slot
+            int slot_start = segments->stacked ? 0 : (int)((float)i * length / segments->count);
+            int slot_end = segments->stacked ? length : (int)((float)(i + 1) * length / segments->count);
+            bar_rectangle(segments, image_cr, slot_start, slot_end - slot_start);
+        } else {
+            bar_rectangle(segments, image_cr, segments->drawn_start[i], segments->drawn_extent[i]);
+        }
+        cairo_fill(image_cr);
+        changed++;
+    }
+    
+    cairo_set_operator(image_cr, CAIRO_OPERATOR_SOURCE);
+    for (guint i = 0; i < segments->count && changed > 0; i++) {
+        if (segments->start[i] == segments->drawn_start[i] && segments->extent[i] == segments->drawn_extent[i]) {
+            continue;
+        }
+        cairo_set_source_rgb(image_cr, segments->colors[i][0], segments->colors[i][1], segments->colors[i][2]);
+        bar_rectangle(segments, image_cr, segments->start[i], segments->extent[i]);
+        cairo_fill(image_cr);
+        segments->drawn_start[i] = segments->start[i];
+        segments->drawn_extent[i] = segments->extent[i];
+    }
+    cairo_destroy(image_cr);
+    
+    // Copy the image over at device resolution
+    cairo_save(cr);
+    cairo_scale(cr, 1.0 / scale, 1.0 / scale);
+    cairo_set_source_surface(cr, segments->image, 0, 0);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_restore(cr);
+}
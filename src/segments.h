@@ -0,0 +1,48 @@
+/*
+ * Segmented multi-value bar.
+ *
+ * One element shows many values - per-core CPU load, several battery
+ * packs - as segments of a single line, updated together by a vector
+ * message ("cpu:40/55/12/80"). Segments sit side by side, each in its own
+ * slot, or are stacked so the filled length is their sum.
+ *
+ * Extents for all segments are computed in one branch-free loop over
+ * plain float/int arrays that the compiler can vectorize. The bar is kept
+ * in a cached image and only segments whose extent changed are cleared
+ * and repainted into it.
+ */
+
+#ifndef SEGMENTS_H
+#define SEGMENTS_H
+
+#include <cairo.h>
+#include <glib.h>
+
+#include "protocol.h"
+
+#define SEGMENTS_MAX UPDATE_SEGMENTS_MAX
+
+typedef struct Segments Segments;
+
+// count segments, side by side or stacked
+Segments *segments_new(guint count, gboolean stacked);
+
+void segments_free(Segments *segments);
+
+// Color of segment index (0.0 - 1.0 components)
+void segments_set_color(Segments *segments, guint index, double r, double g, double b);
+
+// Store the value (0.0 - 1.0) of segment index; out of range indexes are ignored.
+// Returns FALSE if nothing changed.
+gboolean segments_set(Segments *segments, guint index, float value);
+
+guint segments_count(const Segments *segments);
+
+// Mean of all segments (no pass over them)
+float segments_mean(const Segments *segments);
+
+// Paint the bar over width x height. Vertical bars grow from the bottom,
+// horizontal ones from the left.
+void segments_render(Segments *segments, cairo_t *cr, int width, int height, int scale, gboolean vertical);
+
+#endif /* SEGMENTS_H */
@@ -0,0 +1,349 @@
+#define _GNU_SOURCE
+#include "source.h"
+
+#include <glib-unix.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/inotify.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+
+#include "log.h"
+
+#define SOURCE_RESPAWN_DELAY_MS 1000
+#define SOURCE_REAP_WAIT_MS 100     // Grace period after SIGTERM before SIGKILL
+
+static gboolean source_spawn(StatusSource *src);
+
+// Attach to the caller's thread-default context so sources can be driven
+// from the ingest thread as well as from the GTK main loop
+static GSource *source_attach(GSource *gsource, GSourceFunc func, gpointer data) {
+    g_source_set_callback(gsource, func, data, NULL);
+    g_source_attach(gsource, g_main_context_get_thread_default());
+    return gsource;
+}
+
+static void source_detach(GSource **gsource) {
+    if (*gsource) {
+        g_source_destroy(*gsource);
+        g_source_unref(*gsource);
+        *gsource = NULL;
+    }
+}
+
+StatusSource *source_new(SourceKind kind, const char *key, const char *target) {
+    StatusSource *src = g_new0(StatusSource, 1);
+    src->kind = kind;
+    src->key = g_strdup(key);
+    src->target = g_strdup(target);
+    src->field = 0;
+    src->max = 100.0;
+    src->fd = -1;
+    linebuf_init(&src->lines);
+    return src;
+}
+
+void source_set_field(StatusSource *src, int field) {
+    src->field = field > 0 ? field : 0;
+}
+
+gboolean source_set_regex(StatusSource *src, const char *pattern) {
+    GError *error = NULL;
+    GRegex *regex = g_regex_new(pattern, G_REGEX_OPTIMIZE, 0, &error);
+    
+    if (regex == NULL) {
+        log_warn("⚠️  Invalid source regex '%s': %s\n", pattern, error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+    
+    if (src->regex) {
+        g_regex_unref(src->regex);
+    }
+    src->regex = regex;
+    return TRUE;
+}
+
+void source_set_max(StatusSource *src, double max) {
+    src->max = max > 0 ? max : 100.0;
+}
+
+// Pull the configured value out of one line; returns FALSE if it has none
+static gboolean source_extract(StatusSource *src, const char *line, double *raw) {
+    char *text = NULL;
+    
+    if (src->regex) {
+        GMatchInfo *match = NULL;
+        if (g_regex_match(src->regex, line, 0, &match)) {
+            text = g_match_info_fetch(match, g_regex_get_capture_count(src->regex) > 0 ? 1 : 0);
+        }
+        g_match_info_free(match);
+    } else if (src->field > 0) {
+        char **fields = g_strsplit_set(line, " \t", -1);
+        int n = 0;
+        for (char **f = fields; *f != NULL; f++) {
+            if (**f == '\0') {
+                continue; // Runs of separators do not count as fields
+            }
+            if (++n == src->field) {
+                text = g_strdup(*f);
+                break;
+            }
+        }
+        g_strfreev(fields);
+    } else {
+        text = g_strdup(line);
+    }
+    
+    if (text == NULL) {
+        return FALSE;
+    }
+    
+    char *endptr;
+    *raw = g_ascii_strtod(text, &endptr);
+    gboolean ok = endptr != text;
+    g_free(text);
+    return ok;
+}
+
+static void source_handle_line(char *line, void *user_data) {
+    StatusSource *src = user_data;
+    double raw;
+    
+    if (source_extract(src, line, &raw)) {
+        src->func(src->key, (float)(raw / src->max), src->user_data);
+    }
+}
+
+// Command source ------------------------------------------------------------
+
+// Runs in the child between fork and exec: make sure the command does not
+// outlive us if linestatus is killed without a chance to clean up
+static void source_child_setup(gpointer user_data) {
+    (void)user_data;
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+}
+
+// Drop the command's output pipe. Its EOF may come long after the exit
+// (a background grandchild can hold it), and must not hit the next one.
+static void source_close_output(StatusSource *src) {
+    source_detach(&src->fd_watch);
+    if (src->fd >= 0) {
+        close(src->fd);
+        src->fd = -1;
+    }
+}
+
+static gboolean source_respawn(gpointer user_data) {
+    StatusSource *src = user_data;
+    source_detach(&src->respawn_timer);
+    
+    // Keep trying: the command may only be missing or failing for a while
+    if (!source_spawn(src)) {
+        src->respawn_timer = source_attach(g_timeout_source_new(SOURCE_RESPAWN_DELAY_MS), source_respawn, src);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void source_child_exited(GPid pid, gint status, gpointer user_data) {
+    StatusSource *src = user_data;
+    (void)status;
+    
+    g_spawn_close_pid(pid);
+    src->pid = 0;
+    source_detach(&src->child_watch);
+    source_close_output(src);
+    
+    log_warn("⚠️  Source command for %s exited, restarting in %d ms\n", src->key, SOURCE_RESPAWN_DELAY_MS);
+    src->respawn_timer = source_attach(g_timeout_source_new(SOURCE_RESPAWN_DELAY_MS), source_respawn, src);
+}
+
+static gboolean source_command_readable(gint fd, GIOCondition condition, gpointer user_data) {
+    StatusSource *src = user_data;
+    (void)condition;
+    
+    ssize_t result = linebuf_read_fd(&src->lines, fd, source_handle_line, src);
+    if (result > 0 || (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))) {
+        return G_SOURCE_CONTINUE; // Drained, wait for more output
+    }
+    
+    // EOF or error - the child watch takes care of restarting
+    close(fd);
+    if (src->fd == fd) {
+        src->fd = -1;
+        source_detach(&src->fd_watch);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean source_spawn(StatusSource *src) {
+    GError *error = NULL;
+    char **argv = NULL;
+    
+    source_close_output(src);
+    if (!g_shell_parse_argv(src->target, NULL, &argv, &error)) {
+        log_warn("⚠️  Invalid source command '%s': %s\n", src->target, error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+    
+    gboolean spawned = g_spawn_async_with_pipes(NULL, argv, NULL,
+                                                G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD |
+                                                G_SPAWN_STDIN_FROM_DEV_NULL | G_SPAWN_CLOEXEC_PIPES,
+                                                source_child_setup, NULL, &src->pid,
+                                                NULL, &src->fd, NULL, &error);
+    g_strfreev(argv);
+    
+    if (!spawned) {
+        log_warn("⚠️  Failed to start source command '%s': %s\n", src->target, error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+    
+    g_unix_set_fd_nonblocking(src->fd, TRUE, NULL);
+    linebuf_init(&src->lines);
+    src->fd_watch = source_attach(g_unix_fd_source_new(src->fd, G_IO_IN | G_IO_HUP | G_IO_ERR),
+                                  G_SOURCE_FUNC(source_command_readable), src);
+    src->child_watch = source_attach(g_child_watch_source_new(src->pid),
+                                     G_SOURCE_FUNC(source_child_exited), src);
+    
+    log_info("🔌 Source for %s: running '%s' (pid %d)\n", src->key, src->target, src->pid);
+    return TRUE;
+}
+
+// Stop a child whose watch is already gone and reap it, so it does not
+// linger as a zombie: SIGTERM, a short grace period, then SIGKILL
+static void source_reap(GPid pid) {
+    kill(pid, SIGTERM);
+    for (int waited = 0; waited < SOURCE_REAP_WAIT_MS; waited += 10) {
+        pid_t result = waitpid(pid, NULL, WNOHANG);
+        if (result == pid || (result < 0 && errno != EINTR)) {
+            return;
+        }
+        g_usleep(10 * 1000);
+    }
+    kill(pid, SIGKILL);
+    while (waitpid(pid, NULL, 0) < 0 && errno == EINTR) {
+        // Retry
+    }
+}
+
+// File source ---------------------------------------------------------------
+
+static void source_read_file(StatusSource *src) {
+    char buffer[256];
+    int fd = open(src->target, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return; // Not there (yet) - the directory watch reports when it appears
+    }
+    
+    ssize_t bytes_read = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (bytes_read <= 0) {
+        return;
+    }
+    buffer[bytes_read] = '\0';
+    
+    // Only the first line of the file carries the value
+    char *newline = strchr(buffer, '\n');
+    if (newline) {
+        *newline = '\0';
+    }
+    source_handle_line(buffer, src);
+}
+
+static gboolean source_file_changed(gint fd, GIOCondition condition, gpointer user_data) {
+    StatusSource *src = user_data;
+    (void)condition;
+    
+    // Drain every queued event and re-read the file at most once per wakeup
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    gboolean changed = FALSE;
+    ssize_t len;
+    
+    while ((len = read(fd, events, sizeof(events))) > 0) {
+        for (char *p = events; p < events + len; ) {
+            struct inotify_event *event = (struct inotify_event *)p;
+            if (event->len > 0 && strcmp(event->name, src->watch_name) == 0) {
+                changed = TRUE;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    
+    if (changed) {
+        source_read_file(src);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean source_watch_file(StatusSource *src) {
+    // Watch the directory rather than the file so atomic replaces
+    // (write temp + rename) are seen as well as in-place writes
+    char *dir = g_path_get_dirname(src->target);
+    src->watch_name = g_path_get_basename(src->target);
+    
+    src->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (src->fd < 0) {
+        perror("inotify_init1");
+        g_free(dir);
+        return FALSE;
+    }
+    
+    if (inotify_add_watch(src->fd, dir, IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE) < 0) {
+        log_warn("⚠️  Cannot watch %s: %s\n", dir, strerror(errno));
+        close(src->fd);
+        src->fd = -1;
+        g_free(dir);
+        return FALSE;
+    }
+    g_free(dir);
+    
+    src->fd_watch = source_attach(g_unix_fd_source_new(src->fd, G_IO_IN),
+                                  G_SOURCE_FUNC(source_file_changed), src);
+    log_info("👀 Source for %s: watching %s\n", src->key, src->target);
+    
+    // Deliver the current content right away
+    source_read_file(src);
+    return TRUE;
+}
+
+gboolean source_start(StatusSource *src, SourceValueFunc func, gpointer user_data) {
+    src->func = func;
+    src->user_data = user_data;
+    
+    if (src->kind == SOURCE_COMMAND) {
+        return source_spawn(src);
+    }
+    return source_watch_file(src);
+}
+
+void source_free(StatusSource *src) {
+    if (src == NULL) {
+        return;
+    }
+    
+    source_detach(&src->respawn_timer);
+    source_detach(&src->fd_watch);
+    source_detach(&src->child_watch);
+    if (src->pid > 0) {
+        source_reap(src->pid);
+        g_spawn_close_pid(src->pid);
+    }
+    if (src->fd >= 0) {
+        close(src->fd);
+    }
+    if (src->regex) {
+        g_regex_unref(src->regex);
+    }
+    
+    g_free(src->watch_name);
+    g_free(src->key);
+    g_free(src->target);
+    g_free(src);
+}
@@ -0,0 +1,68 @@
+/*
+ * Native value sources - replace the external "loop + send-status + socat"
+ * producers with something linestatus drives itself:
+ *
+ *   command: spawn a long-running command once (pactl subscribe,
+ *            udevadm monitor, a custom meter...) and parse its stdout
+ *            as a stream of lines
+ *   file:    watch a file with inotify and re-read it whenever it changes
+ *
+ * Each line (or file content) is run through an optional regex or field
+ * selector, scaled to a percentage and handed to the same update path the
+ * socket uses.
+ */
+
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <glib.h>
+
+#include "linebuf.h"
+
+typedef enum {
+    SOURCE_COMMAND,
+    SOURCE_FILE
+} SourceKind;
+
+// Receives extracted values, already converted to the 0.0 - 1.0 range
+typedef void (*SourceValueFunc)(const char *key, float value, gpointer user_data);
+
+typedef struct {
+    SourceKind kind;
+    char *key;              // Element the values belong to
+    char *target;           // Command line or file path
+    int field;              // 1-based whitespace separated field, 0 = whole line
+    GRegex *regex;          // Optional, first capture group (or whole match) is the value
+    double max;             // Raw value that maps to 100% (default 100)
+    
+    SourceValueFunc func;
+    gpointer user_data;
+    
+    // Runtime state, attached to the thread-default main context of the
+    // thread that called source_start()
+    GPid pid;               // Command source child, 0 when not running
+    int fd;                 // Command stdout pipe or inotify fd
+    GSource *fd_watch;
+    GSource *child_watch;
+    GSource *respawn_timer;
+    char *watch_name;       // File source: basename matched against inotify events
+    LineBuffer lines;
+} StatusSource;
+
+// Create a source feeding element "key" from a command line or file path
+StatusSource *source_new(SourceKind kind, const char *key, const char *target);
+
+// Optional extraction settings, must be called before source_start()
+void source_set_field(StatusSource *src, int field);
+gboolean source_set_regex(StatusSource *src, const char *pattern);
+void source_set_max(StatusSource *src, double max);
+
+// Spawn the command / install the watch and start delivering values.
+// Callbacks run in the thread-default main context of the caller.
+gboolean source_start(StatusSource *src, SourceValueFunc func, gpointer user_data);
+
+// Stop and free; call from the thread that started the source (or after
+// that thread's main loop has stopped)
+void source_free(StatusSource *src);
+
+#endif /* SOURCE_H */
@@ -0,0 +1,48 @@
+#include "startup.h"
+
+#include "log.h"
+
+typedef struct {
+    const char *name;
+    gint64 time;
+} StartupPhase;
+
+static gboolean enabled = FALSE;
+static gboolean reported = FALSE;
+static gint64 start_time = 0;
+static StartupPhase phases[STARTUP_MAX_PHASES];
+static int num_phases = 0;
+
+void startup_profile_enable(void) {
+    enabled = TRUE;
+    start_time = g_get_monotonic_time();
+}
+
+gboolean startup_profile_enabled(void) {
+    return enabled;
+}
+
+void startup_mark(const char *phase) {
+    if (!enabled || reported || num_phases == STARTUP_MAX_PHASES) {
+        return;
+    }
+    phases[num_phases].name = phase;
+    phases[num_phases].time = g_get_monotonic_time();
+    num_phases++;
+}
+
+void startup_first_frame(void) {
+    if (!enabled || reported) {
+        return;
+    }
+    startup_mark("first_frame");
+    reported = TRUE;
+    
+    gint64 previous = start_time;
+    log_info("⏱️  Startup: %.1f ms from main() to first frame\n",
+             (phases[num_phases - 1].time - start_time) / 1000.0);
+    for (int i = 0; i < num_phases; i++) {
+        log_info("     %-14s %7.1f ms\n", phases[i].name, (phases[i].time - previous) / 1000.0);
+        previous = phases[i].time;
+    }
+}
@@ -0,0 +1,27 @@
+/*
+ * Startup profiling (--startup-profile).
+ *
+ * Phases are marked as startup progresses; when the first frame has been
+ * drawn the time since main() is printed, broken down per phase. Marks
+ * are no-ops unless profiling was enabled.
+ */
+
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <glib.h>
+
+#define STARTUP_MAX_PHASES 16
+
+// Start profiling; call first thing in main()
+void startup_profile_enable(void);
+
+gboolean startup_profile_enabled(void);
+
+// End the current phase (time since the previous mark is attributed to it)
+void startup_mark(const char *phase);
+
+// Mark "first_frame" and print the report (only the first call does anything)
+void startup_first_frame(void);
+
+#endif /* STARTUP_H */
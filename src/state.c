@@ -0,0 +1,98 @@
+#define _GNU_SOURCE
+#include "state.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "log.h"
+
+static StateSnapshot *snapshot = NULL;
+
+gboolean state_open(const char *name) {
+    const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+    char path[256];
+    struct stat st;
+    
+    if (runtime_dir == NULL) {
+        log_debug("💾 XDG_RUNTIME_DIR not set, no warm-start state\n");
+        return FALSE;
+    }
+    snprintf(path, sizeof(path), "%s/linestatus-%s.state", runtime_dir, name);
+    
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        log_warn("⚠️  Cannot open state file %s: %s\n", path, strerror(errno));
+        return FALSE;
+    }
+    
+    // A file of the wrong size cannot be ours (or is brand new)
+    gboolean fresh = fstat(fd, &st) < 0 || st.st_size != (off_t)sizeof(StateSnapshot);
+    if (fresh && ftruncate(fd, sizeof(StateSnapshot)) < 0) {
+        log_warn("⚠️  Cannot size state file %s: %s\n", path, strerror(errno));
+        close(fd);
+        return FALSE;
+    }
+    
+    void *map = mmap(NULL, sizeof(StateSnapshot), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the file
+    if (map == MAP_FAILED) {
+        log_warn("⚠️  Cannot map state file %s: %s\n", path, strerror(errno));
+        return FALSE;
+    }
+    snapshot = map;
+    
+    if (fresh || snapshot->magic != STATE_MAGIC || snapshot->version != STATE_VERSION ||
+        snapshot->entry_size != sizeof(StateEntry)) {
+        memset(snapshot, 0, sizeof(StateSnapshot));
+        snapshot->magic = STATE_MAGIC;
+        snapshot->version = STATE_VERSION;
+        snapshot->entry_size = sizeof(StateEntry);
+        log_debug("💾 New warm-start state at %s\n", path);
+    } else {
+        log_debug("💾 Warm-start state loaded from %s\n", path);
+    }
+    return TRUE;
+}
+
+StateEntry *state_entry(const char *key, gboolean *restored) {
+    StateEntry *free_slot = NULL;
+    
+    *restored = FALSE;
+    if (snapshot == NULL) {
+        return NULL;
+    }
+    
+    for (int i = 0; i < STATE_MAX_ENTRIES; i++) {
+        StateEntry *entry = &snapshot->entries[i];
+        if (entry->key[0] == '\0') {
+            if (free_slot == NULL) {
+                free_slot = entry;
+            }
+        } else if (strncmp(entry->key, key, sizeof(entry->key)) == 0) {
+            // Values from a damaged file are not worth restoring
+            *restored = entry->value >= 0.0f && entry->value <= 1.0f;
+            return entry;
+        }
+    }
+    
+    if (free_slot == NULL) {
+        log_warn("⚠️  State file full, %s will not be remembered\n", key);
+        return NULL;
+    }
+    memset(free_slot, 0, sizeof(*free_slot));
+    g_strlcpy(free_slot->key, key, sizeof(free_slot->key));
+    return free_slot;
+}
+
+void state_close(void) {
+    if (snapshot != NULL) {
+        munmap(snapshot, sizeof(StateSnapshot));
+        snapshot = NULL;
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * Warm-start state snapshot.
+ *
+ * The last value, color and geometry of every element live in a small
+ * file in XDG_RUNTIME_DIR that stays mapped for the lifetime of the
+ * process. Storing a value is a plain write into the mapping - no syscall
+ * per update - and the page outlives the process, so after a crash or a
+ * restart the first frame already shows what was on screen before instead
+ * of a hard-coded default, without producers having to send again.
+ */
+
+#ifndef STATE_H
+#define STATE_H
+
+#include <glib.h>
+#include <stdint.h>
+
+#include "protocol.h"
+
+#define STATE_MAGIC 0x4c535354      // "LSST"
+#define STATE_VERSION 1
+#define STATE_MAX_ENTRIES 16
+
+typedef struct {
+    char key[UPDATE_KEY_MAX];   // Element name, empty for a free slot
+    float value;                // 0.0 - 1.0
+    float r, g, b;              // Line color
+    float x, y;                 // Position (meaning is up to the binary)
+    int32_t vertical;           // Orientation (1 = vertical, 0 = horizontal)
+} StateEntry;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_size;        // sizeof(StateEntry) of the writer
+    uint32_t reserved;
+    StateEntry entries[STATE_MAX_ENTRIES];
+} StateSnapshot;
+
+// Map $XDG_RUNTIME_DIR/linestatus-NAME.state, creating or resetting it if
+// it is missing or from another version. FALSE means no state is kept.
+gboolean state_open(const char *name);
+
+// Entry for key, created if needed; *restored tells whether it existed
+// before. NULL if no state file is open or all slots are taken.
+StateEntry *state_entry(const char *key, gboolean *restored);
+
+// Unmap the snapshot (the file is kept for the next start)
+void state_close(void);
+
+// Remember the latest value; a no-op without an entry
+static inline void state_set_value(StateEntry *entry, float value) {
+    if (entry != NULL) {
+        entry->value = value;
+    }
+}
+
+#endif /* STATE_H */
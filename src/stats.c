@@ -0,0 +1,144 @@
+#include "stats.h"
+
+#include <string.h>
+
+#include "protocol.h"
+
+Stats stats;
+
+typedef struct {
+    char key[UPDATE_KEY_MAX];
+    unsigned long count;
+} KeyCount;
+
+static KeyCount key_counts[STATS_MAX_KEYS];
+static int num_keys = 0;
+static unsigned long other_keys = 0; // Updates for keys beyond STATS_MAX_KEYS
+static atomic_bool presentation_wanted = FALSE; // Set by the first stats_format()
+
+void stats_count_key(const char *key) {
+    stats_inc(&stats.updates_received);
+    
+    for (int i = 0; i < num_keys; i++) {
+        if (strcmp(key_counts[i].key, key) == 0) {
+            key_counts[i].count++;
+            return;
+        }
+    }
+    
+    if (num_keys == STATS_MAX_KEYS) {
+        other_keys++;
+        return;
+    }
+    
+    g_strlcpy(key_counts[num_keys].key, key, sizeof(key_counts[num_keys].key));
+    key_counts[num_keys].count = 1;
+    num_keys++;
+}
+
+static void histogram_add(StatsHistogram *histogram, gint64 latency) {
+    if (latency < 0) {
+        latency = 0;
+    }
+    
+    // Bucket i holds latencies below 2^i µs
+    int bucket = g_bit_storage((gulong)latency);
+    if (bucket >= STATS_LATENCY_BUCKETS) {
+        bucket = STATS_LATENCY_BUCKETS - 1;
+    }
+    
+    stats_inc(&histogram->buckets[bucket]);
+    stats_inc(&histogram->count);
+    atomic_fetch_add_explicit(&histogram->sum_us, (unsigned long)latency, memory_order_relaxed);
+}
+
+void stats_record_latency(gint64 received) {
+    if (received > 0) {
+        histogram_add(&stats.latency, g_get_monotonic_time() - received);
+    }
+}
+
+void stats_record_presented(gint64 received, gint64 sent, gint64 presented) {
+    if (presented <= 0) {
+        stats_inc(&stats.presentation_unknown);
+        return;
+    }
+    
+    stats_inc(&stats.frames_presented);
+    if (received > 0) {
+        histogram_add(&stats.present_latency, presented - received);
+    }
+    if (sent > 0) {
+        // Sender clock is wall time, map the presentation time onto it
+        histogram_add(&stats.end_to_end, presented - g_get_monotonic_time() + g_get_real_time() - sent);
+    }
+}
+
+#define STAT(name) atomic_load_explicit(&stats.name, memory_order_relaxed)
+
+// "name":{"count":N,"mean":M,"buckets":{...}}, buckets as upper bound (µs) -> count
+static void format_histogram(GString *out, const char *name, StatsHistogram *histogram) {
+    unsigned long count = atomic_load_explicit(&histogram->count, memory_order_relaxed);
+    unsigned long sum = atomic_load_explicit(&histogram->sum_us, memory_order_relaxed);
+    
+    g_string_append_printf(out, "\"%s\":{\"count\":%lu,\"mean\":%lu,\"buckets\":{",
+                           name, count, count > 0 ? sum / count : 0);
+    gboolean first = TRUE;
+    for (int i = 0; i < STATS_LATENCY_BUCKETS; i++) {
+        unsigned long n = atomic_load_explicit(&histogram->buckets[i], memory_order_relaxed);
+        if (n == 0) {
+            continue; // Empty buckets are left out
+        }
+        if (i == STATS_LATENCY_BUCKETS - 1) {
+            g_string_append_printf(out, "%s\"inf\":%lu", first ? "" : ",", n);
+        } else {
+            g_string_append_printf(out, "%s\"%lu\":%lu", first ? "" : ",", 1UL << i, n);
+        }
+        first = FALSE;
+    }
+    g_string_append(out, "}}");
+}
+
+gboolean stats_presentation_wanted(void) {
+    return atomic_load_explicit(&presentation_wanted, memory_order_relaxed);
+}
+
+char *stats_format(void) {
+    GString *out = g_string_sized_new(512);
+    
+    // Someone is looking: present_latency_us is filled in from now on
+    atomic_store_explicit(&presentation_wanted, TRUE, memory_order_relaxed);
+    
+    g_string_append_printf(out,
+                           "{\"connections_accepted\":%lu,\"connections_refused\":%lu,"
+                           "\"updates_received\":%lu,\"updates_admitted\":%lu,\"parse_errors\":%lu,"
+                           "\"coalesced\":%lu,\"dropped\":%lu,"
+                           "\"rate_limited\":%lu,\"rate_released\":%lu,\"backpressure_replies\":%lu,"
+                           "\"vectors_split\":%lu,\"redraws_requested\":%lu,\"frames_drawn\":%lu,\"frames_suppressed\":%lu,"
+                           "\"frames_presented\":%lu,\"presentation_unknown\":%lu,",
+                           STAT(connections_accepted), STAT(connections_refused),
+                           STAT(updates_received), STAT(updates_admitted), STAT(parse_errors),
+                           STAT(coalesced), STAT(dropped),
+                           STAT(rate_limited), STAT(rate_released), STAT(backpressure_replies),
+                           STAT(vectors_split),
+                           STAT(redraws_requested), STAT(frames_drawn), STAT(frames_suppressed),
+                           STAT(frames_presented), STAT(presentation_unknown));
+    
+    g_string_append(out, "\"keys\":{");
+    for (int i = 0; i < num_keys; i++) {
+        g_string_append_printf(out, "%s\"%s\":%lu", i > 0 ? "," : "", key_counts[i].key, key_counts[i].count);
+    }
+    if (other_keys > 0) {
+        g_string_append_printf(out, "%s\"(other)\":%lu", num_keys > 0 ? "," : "", other_keys);
+    }
+    
+    g_string_append(out, "},");
+    format_histogram(out, "latency_us", &stats.latency);
+    g_string_append_c(out, ',');
+    format_histogram(out, "present_latency_us", &stats.present_latency);
+    g_string_append_c(out, ',');
+    format_histogram(out, "end_to_end_us", &stats.end_to_end);
+    g_string_append(out, "}\n");
+    
+    return g_string_free(out, FALSE);
+}
@@ -0,0 +1,70 @@
+/*
+ * Live ingest and render counters, queried with the "stats" socket command.
+ *
+ * Global counters are relaxed atomics so both the ingest thread and the
+ * GTK thread can bump them without locking. The per-key table is only
+ * touched by the ingest side (which also formats the reply).
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <glib.h>
+#include <stdatomic.h>
+
+#define STATS_MAX_KEYS 64
+#define STATS_LATENCY_BUCKETS 24    // Power-of-two µs buckets, last one is open-ended
+
+// Power-of-two µs latency histogram
+typedef struct {
+    atomic_ulong count;
+    atomic_ulong sum_us;
+    atomic_ulong buckets[STATS_LATENCY_BUCKETS];
+} StatsHistogram;
+
+typedef struct {
+    atomic_ulong connections_accepted;
+    atomic_ulong connections_refused;
+    atomic_ulong updates_received;
+    atomic_ulong updates_admitted;  // Received updates handed on (all but those still held or replaced while held)
+    atomic_ulong parse_errors;
+    atomic_ulong coalesced;         // Values replaced by a newer one before being drawn
+    atomic_ulong dropped;           // Values that could not be queued at all
+    atomic_ulong rate_limited;      // Values held because their producer was over its rate
+    atomic_ulong rate_released;     // Held values handed on once the producer had tokens again
+    atomic_ulong backpressure_replies;  // "slow" replies sent to streaming clients
+    atomic_ulong vectors_split;     // Apply passes that got the tail of a vector without its start (should stay 0)
+    atomic_ulong redraws_requested;
+    atomic_ulong frames_drawn;
+    atomic_ulong frames_suppressed;     // Redraws skipped while idle or outputs were off
+    atomic_ulong frames_presented;      // Drawn values the compositor reported on screen
+    atomic_ulong presentation_unknown;  // ... for which it reported no presentation time
+    StatsHistogram latency;             // Receive -> draw
+    StatsHistogram present_latency;     // Receive -> on screen (wp_presentation)
+    StatsHistogram end_to_end;          // Sender timestamp -> on screen
+} Stats;
+
+extern Stats stats;
+
+static inline void stats_inc(atomic_ulong *counter) {
+    atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+}
+
+// Count one received update for key (ingest side only)
+void stats_count_key(const char *key);
+
+// Record receive-to-draw latency for a value that was just drawn
+void stats_record_latency(gint64 received);
+
+// Record when a drawn value reached the screen (monotonic µs); sent is the
+// sender's wall clock timestamp or 0
+void stats_record_presented(gint64 received, gint64 sent, gint64 presented);
+
+// Machine-readable snapshot as a single JSON line (ingest side only).
+// The first call also turns on presentation tracking.
+char *stats_format(void);
+
+// Whether anyone asked for the stats yet, i.e. presentation feedback is worth tracking (any thread)
+gboolean stats_presentation_wanted(void);
+
+#endif /* STATS_H */
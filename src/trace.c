@@ -0,0 +1,150 @@
+#define _GNU_SOURCE
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "protocol.h"
+
+typedef struct {
+    atomic_uint seq;            // Slot index + 1 once the event is complete
+    uint32_t id;
+    uint8_t stage;
+    int32_t tid;
+    gint64 timestamp;
+    char key[UPDATE_KEY_MAX];
+} TraceEvent;
+
+atomic_bool trace_enabled = false;
+
+static TraceEvent *ring = NULL;
+static atomic_uint ring_head;       // Next slot to claim, shared by all threads
+static atomic_uint next_id;
+static atomic_uint dump_count;
+
+static const char *stage_names[TRACE_STAGE_COUNT] = {
+    "sent", "accept", "parse", "apply", "queue_draw", "frame_tick", "draw_end", "presented", "coalesced"
+};
+
+void trace_init(void) {
+    if (ring == NULL) {
+        ring = g_new0(TraceEvent, TRACE_RING_SIZE);
+    }
+    atomic_store(&trace_enabled, true);
+}
+
+uint32_t trace_next_id(void) {
+    if (!atomic_load_explicit(&trace_enabled, memory_order_relaxed)) {
+        return 0;
+    }
+    
+    uint32_t id = atomic_fetch_add_explicit(&next_id, 1, memory_order_relaxed) + 1;
+    return id != 0 ? id : trace_next_id(); // Skip 0 on wrap-around
+}
+
+void trace_event_at(TraceStage stage, uint32_t id, const char *key, gint64 timestamp) {
+    if (id == 0 || ring == NULL) {
+        return;
+    }
+    
+    // Claim a slot; writers never wait for each other or for a dump
+    unsigned int index = atomic_fetch_add_explicit(&ring_head, 1, memory_order_relaxed);
+    TraceEvent *event = &ring[index % TRACE_RING_SIZE];
+    
+    atomic_store_explicit(&event->seq, 0, memory_order_relaxed);
+    event->id = id;
+    event->stage = stage;
+    event->tid = gettid();
+    event->timestamp = timestamp;
+    g_strlcpy(event->key, key, sizeof(event->key));
+    atomic_store_explicit(&event->seq, index + 1, memory_order_release);
+}
+
+void trace_event_sent(uint32_t id, const char *key, gint64 sent) {
+    if (id != 0 && sent != 0) {
+        // Map the sender's wall clock onto our monotonic clock
+        trace_event_at(TRACE_SENT, id, key, sent - g_get_real_time() + g_get_monotonic_time());
+    }
+}
+
+// Group by update, then time
+static gint compare_events(gconstpointer a, gconstpointer b) {
+    const TraceEvent *ea = a, *eb = b;
+    
+    if (ea->id != eb->id) {
+        return ea->id < eb->id ? -1 : 1;
+    }
+    if (ea->timestamp != eb->timestamp) {
+        return ea->timestamp < eb->timestamp ? -1 : 1;
+    }
+    return ea->stage < eb->stage ? -1 : ea->stage > eb->stage;
+}
+
+static void write_event(FILE *file, gboolean *first, char phase, const char *name,
+                        const TraceEvent *event) {
+    fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"update\",\"ph\":\"%c\",\"id\":%u,"
+            "\"ts\":%" G_GINT64_FORMAT ",\"pid\":%d,\"tid\":%d,\"args\":{\"key\":\"%s\"}}",
+            *first ? "" : ",", name, phase, event->id, event->timestamp,
+            (int)getpid(), event->tid, event->key);
+    *first = FALSE;
+}
+
+char *trace_dump(void) {
+    if (ring == NULL) {
+        return NULL;
+    }
+    
+    // Snapshot the complete events; slots being rewritten right now are skipped
+    GArray *events = g_array_sized_new(FALSE, FALSE, sizeof(TraceEvent), TRACE_RING_SIZE);
+    unsigned int head = atomic_load_explicit(&ring_head, memory_order_acquire);
+    unsigned int start = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+    for (unsigned int index = start; index != head; index++) {
+        TraceEvent *slot = &ring[index % TRACE_RING_SIZE];
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != index + 1) {
+            continue;
+        }
+        TraceEvent copy;
+        memcpy(&copy, slot, sizeof(copy));
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) == index + 1) {
+            g_array_append_val(events, copy);
+        }
+    }
+    g_array_sort(events, compare_events);
+    
+    const char *dir = getenv("XDG_RUNTIME_DIR");
+    char *path = g_strdup_printf("%s/linestatus-trace-%d-%u.json", dir ? dir : "/tmp", (int)getpid(),
+                                 atomic_fetch_add(&dump_count, 1));
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        log_warn("⚠️  Cannot write trace %s\n", path);
+        g_array_free(events, TRUE);
+        g_free(path);
+        return NULL;
+    }
+    
+    // One async slice per update (named after its key) with a step per stage
+    gboolean first = TRUE;
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    for (guint i = 0; i < events->len; i++) {
+        const TraceEvent *event = &g_array_index(events, TraceEvent, i);
+        gboolean opens = i == 0 || g_array_index(events, TraceEvent, i - 1).id != event->id;
+        gboolean closes = i + 1 == events->len || g_array_index(events, TraceEvent, i + 1).id != event->id;
+        
+        if (opens) {
+            write_event(file, &first, 'b', event->key, event);
+        }
+        write_event(file, &first, 'n', stage_names[event->stage], event);
+        if (closes) {
+            write_event(file, &first, 'e', event->key, event);
+        }
+    }
+    fputs("\n]}\n", file);
+    fclose(file);
+    
+    log_info("🧵 Wrote %u trace events to %s\n", events->len, path);
+    g_array_free(events, TRUE);
+    return path;
+}
@@ -0,0 +1,67 @@
+/*
+ * Opt-in per-update tracing (--trace).
+ *
+ * Every update gets a correlation id when it is parsed, and each pipeline
+ * stage it passes records a timestamped event into a fixed-size in-memory
+ * ring: sender time (from "value@T"), connection accept, parse, apply on
+ * the GTK thread, queue_draw, frame clock tick, the end of the draw
+ * function and, with presentation feedback, the time it reached the
+ * screen. A value replaced by a newer one before it was drawn ends with
+ * a "coalesced" event instead.
+ *
+ * The ring is dumped as Chrome trace JSON (chrome://tracing, Perfetto) on
+ * SIGUSR1 or the "trace" socket command. Each update shows up as one async
+ * slice per key, so it is easy to see whether time goes to ingest, the
+ * frame clock or drawing.
+ *
+ * All timestamps are monotonic µs (g_get_monotonic_time()) except TRACE_SENT,
+ * which is converted from the sender's wall clock when recorded.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <glib.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define TRACE_RING_SIZE 16384       // Events kept, oldest are overwritten
+
+typedef enum {
+    TRACE_SENT,
+    TRACE_ACCEPT,
+    TRACE_PARSE,
+    TRACE_APPLY,
+    TRACE_QUEUE_DRAW,
+    TRACE_FRAME_TICK,
+    TRACE_DRAW_END,
+    TRACE_PRESENTED,
+    TRACE_COALESCED,
+    TRACE_STAGE_COUNT
+} TraceStage;
+
+extern atomic_bool trace_enabled;
+
+// Allocate the ring and start recording
+void trace_init(void);
+
+// Next correlation id, or 0 when tracing is off
+uint32_t trace_next_id(void);
+
+// Record a stage for an update at a given monotonic time (any thread)
+void trace_event_at(TraceStage stage, uint32_t id, const char *key, gint64 timestamp);
+
+// Record a stage happening now; no-op for id 0
+static inline void trace_event(TraceStage stage, uint32_t id, const char *key) {
+    if (id != 0) {
+        trace_event_at(stage, id, key, g_get_monotonic_time());
+    }
+}
+
+// Record the sender's wall clock timestamp (µs since the epoch)
+void trace_event_sent(uint32_t id, const char *key, gint64 sent);
+
+// Write the ring as Chrome trace JSON; returns the file name (g_free) or NULL
+char *trace_dump(void);
+
+#endif /* TRACE_H */
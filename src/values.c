@@ -0,0 +1,332 @@
+#define _GNU_SOURCE
+#include "values.h"
+
+#include <glib-unix.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "log.h"
+
+// Latest values of one key (a single value uses segment 0)
+typedef struct {
+    char key[UPDATE_KEY_MAX];
+    float values[UPDATE_SEGMENTS_MAX];
+    int count;              // Highest segment seen + 1
+    guint64 seq;            // store_seq of its last change
+} ValueKey;
+
+typedef struct {
+    int fd;                 // Own duplicate, outlives the connection's reader
+    GSource *watch;
+    gboolean binary;
+    char **keys;            // NULL for all keys
+    guint64 seen;           // store_seq at the last notification
+    GString *backlog;       // Not yet written
+} Subscriber;
+
+static GMainContext *values_context = NULL;
+static ValueKey *keys[VALUES_MAX_KEYS];
+static int num_keys = 0;
+static guint64 store_seq = 0;
+static GPtrArray *subscribers = NULL;   // Subscriber *
+static GSource *notify_source = NULL;
+static gint64 last_notify = 0;
+static ValuesChangedFunc listener = NULL;
+static gpointer listener_data = NULL;
+static guint64 listener_seen = 0;
+
+static ValueKey *find_key(const char *key) {
+    for (int i = 0; i < num_keys; i++) {
+        if (strcmp(keys[i]->key, key) == 0) {
+            return keys[i];
+        }
+    }
+    return NULL;
+}
+
+// "key:60" or "key:40/55/12"
+static void format_text(GString *out, const ValueKey *entry) {
+    g_string_append_printf(out, "%s:", entry->key);
+    for (int i = 0; i < entry->count; i++) {
+        g_string_append_printf(out, "%s%g", i > 0 ? "/" : "", entry->values[i] * 100.0f);
+    }
+    g_string_append_c(out, '\n');
+}
+
+static void format_binary(GString *out, const ValueKey *entry) {
+    for (int i = 0; i < entry->count; i++) {
+        ValuesRecord record = { .index = i, .value = entry->values[i] };
+        strcpy(record.key, entry->key);
+        g_string_append_len(out, (const char *)&record, sizeof(record));
+    }
+}
+
+// Subscribed keys changed since the subscriber's last notification
+static void format_changes(GString *out, Subscriber *sub) {
+    gsize start = out->len;
+    
+    if (sub->binary) {
+        ValuesFrameHeader header = { .magic = VALUES_FRAME_MAGIC };
+        g_string_append_len(out, (const char *)&header, sizeof(header));
+    }
+    for (int i = 0; i < num_keys; i++) {
+        ValueKey *entry = keys[i];
+        if (entry->seq <= sub->seen || (sub->keys != NULL && !g_strv_contains((const char * const *)sub->keys, entry->key))) {
+            continue;
+        }
+        if (sub->binary) {
+            format_binary(out, entry);
+        } else {
+            format_text(out, entry);
+        }
+    }
+    sub->seen = store_seq;
+    
+    if (sub->binary) {
+        ValuesFrameHeader *header = (ValuesFrameHeader *)(out->str + start);
+        header->count = (out->len - start - sizeof(ValuesFrameHeader)) / sizeof(ValuesRecord);
+        if (header->count == 0) {
+            g_string_truncate(out, start);
+        }
+    }
+}
+
+static void subscriber_free(Subscriber *sub) {
+    if (sub->watch != NULL) {
+        g_source_destroy(sub->watch);
+        g_source_unref(sub->watch);
+    }
+    close(sub->fd);
+    g_strfreev(sub->keys);
+    g_string_free(sub->backlog, TRUE);
+    g_free(sub);
+}
+
+static void subscriber_watch(Subscriber *sub);
+
+static gboolean on_subscriber_io(gint fd, GIOCondition condition, gpointer user_data);
+
+// Write as much of the backlog as the socket takes; FALSE if the subscriber is gone
+static gboolean subscriber_flush(Subscriber *sub) {
+    gboolean had_backlog = sub->backlog->len > 0;
+    
+    while (sub->backlog->len > 0) {
+        ssize_t written = send(sub->fd, sub->backlog->str, sub->backlog->len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return FALSE;
+            }
+            break;
+        }
+        g_string_erase(sub->backlog, 0, written);
+    }
+    
+    // Wait for room only while something is left
+    if (had_backlog != (sub->backlog->len > 0)) {
+        subscriber_watch(sub);
+    }
+    return TRUE;
+}
+
+static void subscriber_watch(Subscriber *sub) {
+    GIOCondition condition = G_IO_HUP | G_IO_ERR;
+    
+    if (sub->watch != NULL) {
+        g_source_destroy(sub->watch);
+        g_source_unref(sub->watch);
+    }
+    if (sub->backlog->len > 0) {
+        condition |= G_IO_OUT;
+    }
+    sub->watch = g_unix_fd_source_new(sub->fd, condition);
+    g_source_set_callback(sub->watch, G_SOURCE_FUNC(on_subscriber_io), sub, NULL);
+    g_source_attach(sub->watch, values_context);
+}
+
+static gboolean on_subscriber_io(gint fd, GIOCondition condition, gpointer user_data) {
+    Subscriber *sub = user_data;
+    (void)fd;
+    
+    if ((condition & (G_IO_HUP | G_IO_ERR)) == 0 && subscriber_flush(sub)) {
+        return G_SOURCE_CONTINUE;
+    }
+    
+    // The watch is destroyed along with the subscriber
+    g_source_unref(sub->watch);
+    sub->watch = NULL;
+    g_ptr_array_remove_fast(subscribers, sub);
+    log_debug("📪 Subscriber left (%u remaining)\n", subscribers->len);
+    return G_SOURCE_REMOVE;
+}
+
+// Once per frame interval at most: tell every subscriber what changed
+static gboolean notify_dispatch(GSource *source, GSourceFunc callback, gpointer user_data) {
+    (void)callback; (void)user_data;
+    
+    g_source_set_ready_time(source, -1);
+    last_notify = g_get_monotonic_time();
+    for (guint i = 0; i < subscribers->len;) {
+        Subscriber *sub = g_ptr_array_index(subscribers, i);
+        
+        // Still writing the previous one: skip, it gets the newest values later
+        if (sub->backlog->len == 0) {
+            format_changes(sub->backlog, sub);
+        }
+        if (!subscriber_flush(sub)) {
+            g_ptr_array_remove_index_fast(subscribers, i);
+            continue;
+        }
+        i++;
+    }
+    
+    if (listener != NULL && store_seq > listener_seen) {
+        listener_seen = store_seq;
+        listener(listener_data);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs notify_source_funcs = {
+    NULL, NULL, notify_dispatch, NULL, NULL, NULL
+};
+
+void values_init(GMainContext *context) {
+    values_context = context;
+    subscribers = g_ptr_array_new_with_free_func((GDestroyNotify)subscriber_free);
+    notify_source = g_source_new(&notify_source_funcs, sizeof(GSource));
+    g_source_set_name(notify_source, "linestatus-values-notify");
+    g_source_attach(notify_source, context);
+}
+
+void values_shutdown(void) {
+    if (subscribers != NULL) {
+        g_ptr_array_free(subscribers, TRUE);
+        subscribers = NULL;
+    }
+    if (notify_source != NULL) {
+        g_source_destroy(notify_source);
+        g_source_unref(notify_source);
+        notify_source = NULL;
+    }
+    for (int i = 0; i < num_keys; i++) {
+        g_free(keys[i]);
+    }
+    num_keys = 0;
+    listener = NULL;
+    values_context = NULL;
+}
+
+void values_store(const Update *update) {
+    ValueKey *entry = find_key(update->key);
+    
+    if (entry == NULL) {
+        if (num_keys == VALUES_MAX_KEYS) {
+            return;
+        }
+        entry = keys[num_keys++] = g_new0(ValueKey, 1);
+        g_strlcpy(entry->key, update->key, sizeof(entry->key));
+    }
+    if (update->index >= UPDATE_SEGMENTS_MAX) {
+        return;
+    }
+    entry->values[update->index] = update->value;
+    entry->count = MAX(entry->count, update->index + 1);
+    entry->seq = ++store_seq;
+    
+    // First change since the last notification: schedule the next one
+    if (subscribers != NULL && (subscribers->len > 0 || listener != NULL) &&
+        g_source_get_ready_time(notify_source) == -1) {
+        g_source_set_ready_time(notify_source, MAX(g_get_monotonic_time(), last_notify + VALUES_NOTIFY_INTERVAL_US));
+    }
+}
+
+gboolean values_lookup(const char *key, int index, float *value) {
+    ValueKey *entry = find_key(key);
+    
+    if (entry == NULL || index >= entry->count) {
+        return FALSE;
+    }
+    *value = entry->values[index];
+    return TRUE;
+}
+
+void values_foreach(ValuesForeachFunc func, gpointer user_data) {
+    for (int i = 0; i < num_keys; i++) {
+        func(keys[i]->key, keys[i]->values, keys[i]->count, user_data);
+    }
+}
+
+void values_set_listener(ValuesChangedFunc func, gpointer user_data) {
+    listener = func;
+    listener_data = user_data;
+    listener_seen = store_seq; // Only changes from now on
+}
+
+char *values_command_get(const char *args) {
+    ValueKey *entry = find_key(args);
+    GString *out = g_string_new(NULL);
+    
+    if (entry != NULL) {
+        format_text(out, entry);
+    } else {
+        g_string_printf(out, "error: no value for '%s'\n", args);
+    }
+    return g_string_free(out, FALSE);
+}
+
+const char *values_command_subscribe(int fd, const char *args) {
+    char **words = g_strsplit_set(args, " \t", -1);
+    char **names = words;
+    Subscriber *sub;
+    
+    if (subscribers->len >= VALUES_MAX_SUBSCRIBERS) {
+        g_strfreev(words);
+        return "error: too many subscribers\n";
+    }
+    
+    sub = g_new0(Subscriber, 1);
+    sub->fd = dup(fd); // The reading side may close its fd at EOF, we keep writing
+    sub->backlog = g_string_new(NULL);
+    if (names[0] != NULL && strcmp(names[0], "binary") == 0) {
+        sub->binary = TRUE;
+        names++;
+    }
+    
+    // Remaining words are the keys, none means all of them
+    GPtrArray *wanted = g_ptr_array_new();
+    for (; *names != NULL; names++) {
+        if (**names != '\0') {
+            g_ptr_array_add(wanted, g_strdup(*names));
+        }
+    }
+    if (wanted->len > 0) {
+        g_ptr_array_add(wanted, NULL);
+        sub->keys = (char **)g_ptr_array_free(wanted, FALSE);
+    } else {
+        g_ptr_array_free(wanted, TRUE);
+    }
+    g_strfreev(words);
+    
+    if (sub->fd < 0) {
+        g_string_free(sub->backlog, TRUE);
+        g_strfreev(sub->keys);
+        g_free(sub);
+        return "error: cannot subscribe\n";
+    }
+    
+    // Current values right away, changes from here on
+    g_ptr_array_add(subscribers, sub);
+    format_changes(sub->backlog, sub);
+    subscriber_watch(sub);
+    if (!subscriber_flush(sub)) {
+        g_ptr_array_remove_fast(subscribers, sub);
+        return NULL; // Already gone, nobody to tell
+    }
+    log_debug("📬 New %s subscriber (%u total)\n", sub->binary ? "binary" : "text", subscribers->len);
+    return NULL;
+}
@@ -0,0 +1,75 @@
+/*
+ * Current values, readable over the socket.
+ *
+ * Every value that reaches linestatus is also kept here, on the ingest
+ * side, so other tools (status bars, OSDs) can read it instead of polling
+ * pactl, brightnessctl or sysfs themselves:
+ *
+ *   get volume                  -> "volume:60"  (vectors: "cpu:40/55/12")
+ *   subscribe volume brightness -> current values, then every change
+ *   subscribe                   -> all keys
+ *   subscribe binary cpu        -> the same as ValuesFrame records
+ *
+ * A subscriber keeps its connection open. Changes are coalesced and sent
+ * at most once per frame interval, one line (or record) per changed key,
+ * in the same "key:value" format the socket accepts. A subscriber that
+ * does not keep up is not sent anything new until its backlog is written,
+ * so it simply sees fewer, newer values.
+ *
+ * Everything here runs on the ingest thread.
+ */
+
+#ifndef VALUES_H
+#define VALUES_H
+
+#include <glib.h>
+#include <stdint.h>
+
+#include "protocol.h"
+
+#define VALUES_MAX_KEYS 64
+#define VALUES_MAX_SUBSCRIBERS 32
+#define VALUES_NOTIFY_INTERVAL_US 16667     // Fixed ~60 Hz, not the display's frame clock
+#define VALUES_FRAME_MAGIC 0x4c535631       // "LSV1"
+
+// Binary subscription: a header followed by count records (native byte order)
+typedef struct {
+    uint32_t magic;
+    uint32_t count;
+} ValuesFrameHeader;
+
+typedef struct {
+    char key[UPDATE_KEY_MAX];
+    uint16_t index;         // Segment
+    uint16_t reserved;
+    float value;            // 0.0 - 1.0
+} ValuesRecord;
+
+// Called at most once per notification interval when any value changed
+typedef void (*ValuesChangedFunc)(gpointer user_data);
+
+// Called for every stored key with its segment values (count >= 1)
+typedef void (*ValuesForeachFunc)(const char *key, const float *values, int count, gpointer user_data);
+
+// Set up on the ingest context / tear down, dropping all subscribers
+void values_init(GMainContext *context);
+void values_shutdown(void);
+
+// Remember a value and schedule notifications for its subscribers
+void values_store(const Update *update);
+
+// Current value of a key's segment; FALSE if it was never set
+gboolean values_lookup(const char *key, int index, float *value);
+
+void values_foreach(ValuesForeachFunc func, gpointer user_data);
+
+// One in-process listener besides the socket subscribers (NULL to remove)
+void values_set_listener(ValuesChangedFunc func, gpointer user_data);
+
+// "get KEY" and "subscribe [binary] [KEY...]" from client fd; args is the rest of the line.
+// Both hand back the reply for the caller to send: get's is g_free'd by the caller,
+// subscribe's is a static error or NULL once the subscriber is live.
+char *values_command_get(const char *args);
+const char *values_command_subscribe(int fd, const char *args);
+
+#endif /* VALUES_H */